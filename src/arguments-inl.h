@@ -27,6 +27,51 @@ namespace andrews_curtis
         return m_is_valid ? 0 : 1;
     }
     
+    inline bool Arguments::is_cyclic() const
+    {
+        return m_is_cyclic;
+    }
+    
+    inline bool Arguments::is_canonical() const
+    {
+        return m_is_canonical;
+    }
+    
+    inline bool Arguments::is_hashed() const
+    {
+        return m_is_hashed;
+    }
+    
+    inline bool Arguments::is_fingerprinted() const
+    {
+        return m_is_fingerprinted;
+    }
+    
+    inline bool Arguments::is_prefiltered() const
+    {
+        return m_is_prefiltered;
+    }
+    
+    inline bool Arguments::is_external() const
+    {
+        return !m_external_directory.empty();
+    }
+    
+    inline const std::string &Arguments::get_external_directory() const
+    {
+        return m_external_directory;
+    }
+    
+    inline bool Arguments::is_frozen() const
+    {
+        return m_is_frozen;
+    }
+    
+    inline bool Arguments::is_fast_exit() const
+    {
+        return m_is_fast_exit;
+    }
+    
     inline char **Arguments::get_relators() const
     {
         return m_relators;
@@ -11,6 +11,7 @@
 #include <cstring>
 
 #include "globals.h"
+#include "relator.h"
 #include "arguments.h"
 
 
@@ -20,16 +21,164 @@ namespace andrews_curtis
     long g_children_count = 0;
     long g_relators_count = 0;
     long g_bits_per_letter = 0;
+    long g_letters_per_block = 0;
     long g_generators_count = 0;
+    bool g_is_cyclic = false;
+    bool g_is_canonical = false;
+    bool g_is_hashed = false;
+    bool g_is_fingerprinted = false;
+    bool g_is_prefiltered = false;
+    bool g_is_external = false;
+    bool g_is_frozen = false;
     
     Arguments::Arguments(int argc,char *argv[])
     :   m_message(),
         m_is_valid(true),
+        m_is_cyclic(false),
+        m_is_canonical(false),
+        m_is_hashed(false),
+        m_is_fingerprinted(false),
+        m_is_prefiltered(false),
+        m_external_directory(),
+        m_is_frozen(false),
+        m_is_fast_exit(false),
         m_relators(0),
         m_generators(0)
     {
+        // Define the index of the first argument that is not an option
+        int first = 1;
+        
+        // Loop over the options, which precede the generators
+        for(; (first < argc) && ('-' == argv[first][0]); ++first)
+        {
+            // Check for the cyclic option
+            if(!std::strcmp(argv[first], "--cyclic"))
+            {
+                // Flag cyclic mode
+                m_is_cyclic = true;
+            }
+            // Check for the canonical option
+            else if(!std::strcmp(argv[first], "--canonical"))
+            {
+                // Flag canonical mode
+                m_is_canonical = true;
+            }
+            // Check for the hashed option
+            else if(!std::strcmp(argv[first], "--hashed"))
+            {
+                // Flag hashed mode
+                m_is_hashed = true;
+            }
+            // Check for the fingerprinted option
+            else if(!std::strcmp(argv[first], "--fingerprinted"))
+            {
+                // Flag fingerprinted mode
+                m_is_fingerprinted = true;
+            }
+            // Check for the prefiltered option
+            else if(!std::strcmp(argv[first], "--prefiltered"))
+            {
+                // Flag prefiltered mode
+                m_is_prefiltered = true;
+            }
+            // Check for the external option, followed by its directory
+            else if(!std::strcmp(argv[first], "--external"))
+            {
+                // Check that the directory follows
+                if((first + 1) >= argc)
+                {
+                    // Set message
+                    m_message = "The option --external needs a directory.";
+                    
+                    // Flag validity
+                    m_is_valid = false;
+                    
+                    // Return
+                    return;
+                }
+                
+                // Set the directory, skipping it
+                m_external_directory = argv[++first];
+            }
+            // Check for the frozen option
+            else if(!std::strcmp(argv[first], "--frozen"))
+            {
+                // Flag frozen mode
+                m_is_frozen = true;
+            }
+            // Check for the fast exit option
+            else if(!std::strcmp(argv[first], "--fast-exit"))
+            {
+                // Flag fast exit mode
+                m_is_fast_exit = true;
+            }
+            else
+            {
+                // Set message
+                m_message = std::string("Unknown option ") + argv[first] + ".";
+                
+                // Flag validity
+                m_is_valid = false;
+                
+                // Return
+                return;
+            }
+        }
+        
+        // Check that at most one store for the presentations found is asked for
+        if(m_is_hashed && m_is_fingerprinted)
+        {
+            // Set message
+            m_message = "The options --hashed and --fingerprinted may not be combined.";
+            
+            // Flag validity
+            m_is_valid = false;
+            
+            // Return
+            return;
+        }
+        
+        // Check that the Bloom_filter is only asked for where children are looked up locally
+        if(m_is_prefiltered && (m_is_cyclic || m_is_canonical))
+        {
+            // Set message
+            m_message = "The option --prefiltered may not be combined with --cyclic or --canonical.";
+            
+            // Flag validity
+            m_is_valid = false;
+            
+            // Return
+            return;
+        }
+        
+        // Check that external mode, which keeps no store in memory, is not combined with one
+        if(!m_external_directory.empty() && (m_is_hashed || m_is_fingerprinted || m_is_prefiltered))
+        {
+            // Set message
+            m_message = "The option --external may not be combined with --hashed, --fingerprinted or --prefiltered.";
+            
+            // Flag validity
+            m_is_valid = false;
+            
+            // Return
+            return;
+        }
+        
+        // Check that frozen mode, which freezes the levels of the Binary_tree or Fingerprint_set, is not combined with another store
+        if(m_is_frozen && (m_is_hashed || !m_external_directory.empty()))
+        {
+            // Set message
+            m_message = "The option --frozen may not be combined with --hashed or --external.";
+            
+            // Flag validity
+            m_is_valid = false;
+            
+            // Return
+            return;
+        }
+        
         // Check if there are to few arguments
-        if(argc < 3)
+        if((argc - first) < 2)
         {
             // Set message
             m_message = "To few arguments.";
@@ -42,7 +191,7 @@ namespace andrews_curtis
         }
         
         // Check that the presentation is balanced
-        if(std::strlen(argv[1]) != (argc - 2))
+        if(std::strlen(argv[first]) != (argc - first - 1))
         {
             // Set message
             m_message = "The presentation is not balanced.";
@@ -64,7 +213,7 @@ namespace andrews_curtis
         bool is_valid = false;
         
         // Check that relators contain only generators and inverses
-        for(int count = 2; count <  argc; ++count) 
+        for(int count = first + 1; count <  argc; ++count) 
         {
             // Obtain current relator
             relator = argv[count];
@@ -76,7 +225,7 @@ namespace andrews_curtis
                 is_valid = false;
                 
                 // Obtain generators
-                generators = argv[1];
+                generators = argv[first];
                 
                 // Loop over generators
                 do 
@@ -105,10 +254,10 @@ namespace andrews_curtis
         }
         
         // Set m_generators
-        m_generators = argv[1];
+        m_generators = argv[first];
         
         // Set m_relators
-        m_relators = &argv[2];
+        m_relators = &argv[first + 1];
         
         // Set g_generators_count
         g_generators_count = std::strlen(m_generators);
@@ -121,5 +270,32 @@ namespace andrews_curtis
         
         // Set g_bits_per_letter (The min bit count needed to represent 2 * g_generators_count)
         g_bits_per_letter = (std::log(2 * g_generators_count) / std::log(2)) + 1;
+        
+        // Round g_bits_per_letter up to a nibble or byte so letters never straddle a Block
+        g_bits_per_letter = (g_bits_per_letter <= 4) ? 4 : 8;
+        
+        // Set g_letters_per_block
+        g_letters_per_block = Relator::s_bits_per_block / g_bits_per_letter;
+        
+        // Set g_is_cyclic
+        g_is_cyclic = m_is_cyclic;
+        
+        // Set g_is_canonical
+        g_is_canonical = m_is_canonical;
+        
+        // Set g_is_hashed
+        g_is_hashed = m_is_hashed;
+        
+        // Set g_is_fingerprinted
+        g_is_fingerprinted = m_is_fingerprinted;
+        
+        // Set g_is_prefiltered
+        g_is_prefiltered = m_is_prefiltered;
+        
+        // Set g_is_external
+        g_is_external = !m_external_directory.empty();
+        
+        // Set g_is_frozen
+        g_is_frozen = m_is_frozen;
     }
 }
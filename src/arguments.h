@@ -62,6 +62,91 @@ namespace andrews_curtis
         ///
         int get_return_code() const;
         
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --cyclic option, for relators to be identified up to
+        /// cyclic permutation.
+        ///
+        /// \return A bool indicating cyclic mode
+        ///
+        bool is_cyclic() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --canonical option, for presentations to be identified
+        /// up to relator order, relator orientation and generator
+        /// relabeling.
+        ///
+        /// \return A bool indicating canonical mode
+        ///
+        bool is_canonical() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --hashed option, for the presentations found to be
+        /// stored in the concurrent Hash_set.
+        ///
+        /// \return A bool indicating hashed mode
+        ///
+        bool is_hashed() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --fingerprinted option, for only the fingerprints of
+        /// the presentations found to be stored, in the
+        /// Fingerprint_set.
+        ///
+        /// \return A bool indicating fingerprinted mode
+        ///
+        bool is_fingerprinted() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --prefiltered option, for the presentations found to be
+        /// checked against the Bloom_filter before they are looked
+        /// up.
+        ///
+        /// \return A bool indicating prefiltered mode
+        ///
+        bool is_prefiltered() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --external option, for the presentations found to be
+        /// stored on disk, in the External_store.
+        ///
+        /// \return A bool indicating external mode
+        ///
+        bool is_external() const;
+        
+        ///
+        /// Obtain the directory, passed with the --external option,
+        /// in which the External_store keeps its files
+        ///
+        /// \return The directory of the External_store, empty if none
+        ///
+        const std::string &get_external_directory() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --frozen option, for the presentations of completed
+        /// levels to be frozen into the Frozen_set, or with
+        /// --fingerprinted their relator ids into the
+        /// Succinct_set.
+        ///
+        /// \return A bool indicating frozen mode
+        ///
+        bool is_frozen() const;
+        
+        ///
+        /// Returns a bool indicating if the user asked, with the
+        /// --fast-exit option, for the program to exit once the
+        /// results are out, skipping the teardown.
+        ///
+        /// \return A bool indicating fast exit mode
+        ///
+        bool is_fast_exit() const;
+        
         ///
         /// Obtain the user supplied relators
         ///
@@ -82,6 +167,30 @@ namespace andrews_curtis
         /// A bool indicating validity
         bool m_is_valid;  
         
+        /// A bool indicating cyclic mode
+        bool m_is_cyclic;
+        
+        /// A bool indicating canonical mode
+        bool m_is_canonical;
+        
+        /// A bool indicating hashed mode
+        bool m_is_hashed;
+        
+        /// A bool indicating fingerprinted mode
+        bool m_is_fingerprinted;
+        
+        /// A bool indicating prefiltered mode
+        bool m_is_prefiltered;
+        
+        /// The directory of the External_store, empty if not in external mode
+        std::string m_external_directory;
+        
+        /// A bool indicating frozen mode
+        bool m_is_frozen;
+        
+        /// A bool indicating fast exit mode
+        bool m_is_fast_exit;
+        
         /// User supplied relators
         char **m_relators;
         
@@ -14,42 +14,94 @@
 
 #include "globals.h"
 #include "relator.h"
+#include "relator_table.h"
 
 
 namespace andrews_curtis
 {
     inline Balanced_presentation::Balanced_presentation()
-    :   m_relators(new Relator*[g_relators_count]),
-        m_parent(0),
-        m_parent_process(0),
+    :   m_parent(0),
         m_left(0),
-        m_right(0)
+        m_right(0),
+        m_key(0)
     {
     }
     
     inline Balanced_presentation::~Balanced_presentation()
     {
-        delete[] m_relators;
     }
     
-    inline const Balanced_presentation*  const &Balanced_presentation::get_parent() const
+    inline bool Balanced_presentation::has_parent() const
     {
-        return m_parent;
+        return 0 != m_parent;
+    }
+    
+    inline const Balanced_presentation *Balanced_presentation::get_parent() const
+    {
+        return get_handled(m_parent);
     }
     
     inline unsigned int Balanced_presentation::get_parent_process() const
     {
-        return m_parent_process;
+        return static_cast<unsigned int>(m_parent >> 32);
+    }
+    
+    inline boost::uint64_t Balanced_presentation::get_handle(unsigned int process) const
+    {
+        return (static_cast<boost::uint64_t>(process) << 32) | get_link(this);
+    }
+    
+    inline boost::uint64_t Balanced_presentation::get_parent_handle() const
+    {
+        return m_parent;
+    }
+    
+    inline const Balanced_presentation *Balanced_presentation::get_handled(boost::uint64_t handle)
+    {
+        return get_linked(static_cast<boost::uint32_t>(handle));
+    }
+    
+    inline void Balanced_presentation::set_parent(boost::uint64_t parent)
+    {
+        m_parent = parent;
+    }
+    
+    inline Balanced_presentation *Balanced_presentation::get_left() const
+    {
+        return get_linked(m_left);
+    }
+    
+    inline Balanced_presentation *Balanced_presentation::get_right() const
+    {
+        return get_linked(m_right);
+    }
+    
+    inline void Balanced_presentation::set_left(Balanced_presentation *left)
+    {
+        m_left = get_link(left);
+    }
+    
+    inline void Balanced_presentation::set_right(Balanced_presentation *right)
+    {
+        m_right = get_link(right);
+    }
+    
+    inline const Relator *Balanced_presentation::get_relator(int unsigned &index) const
+    {
+        return Relator_table::get_relator(m_relators[index]);
     }
     
-    inline Relator *Balanced_presentation::get_relator(int unsigned &index) const
+    inline unsigned int Balanced_presentation::get_relator_id(int unsigned &index) const
     {
         return m_relators[index];
     }
     
-    inline void Balanced_presentation::set_relator(Relator *relator, int unsigned &index)
+    inline void Balanced_presentation::set_relator(unsigned int relator, int unsigned &index)
     {
         m_relators[index] = relator;
+        
+        // Update m_key to the new relator
+        update_key();
     }
     
     inline unsigned int Balanced_presentation::get_process() const
@@ -57,9 +109,14 @@ namespace andrews_curtis
         // Define variable to hold the sum of the relators
         std::size_t relator_sum = 0;
         
-        // Sum the relators
-        for(unsigned int index = 0; index < g_relators_count; ++index)
-            relator_sum += static_cast<std::size_t>(*m_relators[index]);
+        // Sum the relators, specialized on the number of relators
+        switch(g_relators_count)
+        {
+            case 2: relator_sum = get_relator_sum<2>(); break;
+            case 3: relator_sum = get_relator_sum<3>(); break;
+            case 4: relator_sum = get_relator_sum<4>(); break;
+            default: relator_sum = get_relator_sum<0>(); break;
+        }
 
         // Access the world communicator
         boost::mpi::communicator communicator;
@@ -68,13 +125,75 @@ namespace andrews_curtis
         return relator_sum % communicator.size();
     }
     
+    inline unsigned int Balanced_presentation::get_process(const std::vector<Relator> &relators)
+    {
+        // Define variable to hold the sum of the relators
+        std::size_t relator_sum = 0;
+        
+        // Sum the relators, as get_relator_sum() does the interned Relators
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+            relator_sum += static_cast<std::size_t>(relators[index]);
+        
+        // Access the world communicator
+        boost::mpi::communicator communicator;
+        
+        // Return the process on which the presentation should reside
+        return relator_sum % communicator.size();
+    }
+    
+    inline unsigned int Balanced_presentation::get_child_process(int unsigned &index, std::size_t hash) const
+    {
+        // Define variable to hold the sum of the relators
+        std::size_t relator_sum = 0;
+        
+        // Sum the relators, specialized on the number of relators
+        switch(g_relators_count)
+        {
+            case 2: relator_sum = get_relator_sum<2>(); break;
+            case 3: relator_sum = get_relator_sum<3>(); break;
+            case 4: relator_sum = get_relator_sum<4>(); break;
+            default: relator_sum = get_relator_sum<0>(); break;
+        }
+        
+        // Replace the hash of the relator at index with the passed hash
+        relator_sum = relator_sum - static_cast<std::size_t>(*get_relator(index)) + hash;
+        
+        // Access the world communicator
+        boost::mpi::communicator communicator;
+        
+        // Return the process on which the child should reside
+        return relator_sum % communicator.size();
+    }
+    
+    inline void Balanced_presentation::make_child_of(const Balanced_presentation &parent, unsigned int parent_process)
+    {
+        // Assign Relators's ids, specialized on the number of relators
+        switch(g_relators_count)
+        {
+            case 2: copy_relators<2>(parent); break;
+            case 3: copy_relators<3>(parent); break;
+            case 4: copy_relators<4>(parent); break;
+            default: copy_relators<0>(parent); break;
+        }
+        
+        // Assign m_key, that of parent as the relators are
+        m_key = parent.m_key;
+        
+        // Assign m_parent, the handle of parent on parent_process
+        m_parent = parent.get_handle(parent_process);
+        
+        // Assign m_left and m_right, we are not in the BST yet
+        m_left = 0;
+        m_right = 0;
+    }
+    
     inline bool Balanced_presentation::is_trivial() const
     {
         // Populate relator_set
         for(unsigned int index = 0; index < g_relators_count; ++index) 
         {
             // Check if m_relators[count] has length 1
-            if(1 != m_relators[index]->get_length())
+            if(1 != get_relator(index)->get_length())
                 return false;
         }
         
@@ -89,23 +208,58 @@ namespace andrews_curtis
         
         // Append "[relator]," for all but the last relator
         for(unsigned int index = 0; index < (g_relators_count - 1); ++index)
-            to_string += m_relators[index]->to_string() + ", ";
+            to_string += get_relator(index)->to_string() + ", ";
         
         // Append "[relator])\n" for the last relator 
-        to_string += m_relators[g_relators_count - 1]->to_string() + ")\n";
+        unsigned int last = g_relators_count - 1;
+        to_string += get_relator(last)->to_string() + ")\n";
         
         // Return result
         return to_string;
     }
     
+    inline std::size_t Balanced_presentation::get_hash() const
+    {
+        // Hash the ids, specialized on the number of relators
+        switch(g_relators_count)
+        {
+            case 2: return get_id_hash<2>();
+            case 3: return get_id_hash<3>();
+            case 4: return get_id_hash<4>();
+            default: return get_id_hash<0>();
+        }
+    }
+    
+    inline void Balanced_presentation::get_fingerprint(boost::uint64_t &high, boost::uint64_t &low) const
+    {
+        // Start from the fingerprint of no relators
+        high = 0;
+        low = 0;
+        
+        // Mix in the relators in turn
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+            get_relator(index)->add_to_fingerprint(high, low);
+    }
+    
+    inline void Balanced_presentation::get_child_fingerprint(int unsigned &index, const Relator &relator, boost::uint64_t &high, boost::uint64_t &low) const
+    {
+        // Start from the fingerprint of no relators
+        high = 0;
+        low = 0;
+        
+        // Mix in the relators in turn, relator in place of the relator at index
+        for(unsigned int current = 0; current < g_relators_count; ++current)
+            ((current == index) ? &relator : get_relator(current))->add_to_fingerprint(high, low);
+    }
+    
     inline size_t Balanced_presentation::get_length() const
     {
         // Define variable to hold length
         size_t length = 0;
         
         // Loop over relators and summ their lengths
-        for(int index = 0; index < g_relators_count; ++index)
-            length += m_relators[index]->get_length();
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+            length += get_relator(index)->get_length();
         
         // Return length
         return length;
@@ -117,24 +271,13 @@ namespace andrews_curtis
         if(this == &rhs)
             return *this;
         
-        // Assign Relators's
-        for(int index = 0; index < g_relators_count; ++index)
-            *m_relators[index] = *rhs.m_relators[index];
-        
         // Note: operator= is used as the first step in creating a child of a
-        //       Balanced_presentation. Hence, the next few assignments, that
-        //       seem odd at first, are odd in that they are used in that con-
-        //       ext and that context only.
+        //       Balanced_presentation. Hence, it makes this instance a child
+        //       of rhs, which, seeming odd at first, is odd in that it is used
+        //       in that context and that context only.
         
-        // Assign m_parent
-        m_parent = &rhs;
-        
-        // Assign m_parent_process
-        m_parent_process = rhs.get_process();
-        
-        // Assign m_left and m_right, we are not in the BST yet
-        m_left = 0;
-        m_right = 0;
+        // Make this instance a child of rhs
+        make_child_of(rhs, rhs.get_process());
         
         // Return *this
         return *this;
@@ -142,11 +285,29 @@ namespace andrews_curtis
     
     inline bool Balanced_presentation::operator==(const Balanced_presentation &rhs) const
     {
+        // Compare, specialized on the number of relators
+        switch(g_relators_count)
+        {
+            case 2: return is_equal<2>(rhs);
+            case 3: return is_equal<3>(rhs);
+            case 4: return is_equal<4>(rhs);
+            default: return is_equal<0>(rhs);
+        }
+    }
+    
+    template <unsigned int Relators>
+    inline bool Balanced_presentation::is_equal(const Balanced_presentation &rhs) const
+    {
+        // Presentations with different keys differ (Note: rejects almost all
+        // unequal presentations on one compare)
+        if(m_key != rhs.m_key)
+            return false;
+        
         // Loop over relators
-        for(int unsigned index = 0; index < g_relators_count; ++index)
+        for(int unsigned index = 0; index < get_relators_count<Relators>(); ++index)
         {
             // Check for inequality
-            if(*m_relators[index] != *rhs.m_relators[index])
+            if(m_relators[index] != rhs.m_relators[index])
                 return false;
         }
         
@@ -161,83 +322,103 @@ namespace andrews_curtis
     
     inline bool Balanced_presentation::operator<(const Balanced_presentation &rhs) const
     {
-        // Loop over relators
-        for(int unsigned index = 0; index < g_relators_count; ++index)
+        // Compare, specialized on the number of relators
+        switch(g_relators_count)
         {
-            // Check for greater-than-or-equal
-            if(*m_relators[index] >= *rhs.m_relators[index])
-                return false;
+            case 2: return is_less<2>(rhs);
+            case 3: return is_less<3>(rhs);
+            case 4: return is_less<4>(rhs);
+            default: return is_less<0>(rhs);
         }
-        
-        // Indicate less than
-        return true;
     }
     
-    inline bool Balanced_presentation::operator<=(const Balanced_presentation &rhs) const
+    template <unsigned int Relators>
+    inline bool Balanced_presentation::is_less(const Balanced_presentation &rhs) const
     {
-        return !operator>(rhs);
+        // Note: Presentations are ordered by m_key, then lexicographically by
+        //       the ids of their relators; so, < is a strict weak ordering, as
+        //       the rebuilding binary search tree needs. Ids are handed out in
+        //       order of interning, so ordering by the hash in m_key first also
+        //       keeps presentations from being inserted in increasing order,
+        //       which would make the binary search tree rebuild often.
+        
+        // The keys decide, unless equal (Note: almost always on one compare)
+        if(m_key != rhs.m_key)
+            return m_key < rhs.m_key;
+        
+        // Loop over relators, comparing lexicographically
+        for(int unsigned index = 0; index < get_relators_count<Relators>(); ++index)
+        {
+            // The first differing relator decides
+            if(m_relators[index] != rhs.m_relators[index])
+                return m_relators[index] < rhs.m_relators[index];
+        }
+        
+        // Indicate equality, so not less than
+        return false;
     }
     
-    inline bool Balanced_presentation::operator>(const Balanced_presentation &rhs) const
+    inline void Balanced_presentation::update_key()
     {
-        return (rhs < *this);
+        // Take the high bits of the hash of the ids, the best mixed
+        m_key = static_cast<boost::uint32_t>(static_cast<boost::uint64_t>(get_hash()) >> 32);
     }
     
-    inline bool Balanced_presentation::operator>=(const Balanced_presentation &rhs) const
+    template <unsigned int Relators>
+    inline unsigned int Balanced_presentation::get_relators_count()
     {
-        return !operator<(rhs);
+        return Relators ? Relators : g_relators_count;
     }
     
-    // Union allowing serialization of a pointer to a Balanced_presentation,
-    // while not serializing the Balanced_presentation itself. The apropos
-    // member is used to obtain the pointer as a number or number as a pointer.
-    union Intpoint
+    template <unsigned int Relators>
+    inline std::size_t Balanced_presentation::get_relator_sum() const
     {
-        // The number
-        unsigned long number;
+        // Define variable to hold the sum of the relators
+        std::size_t relator_sum = 0;
+        
+        // Sum the relators
+        for(unsigned int index = 0; index < get_relators_count<Relators>(); ++index)
+            relator_sum += static_cast<std::size_t>(*Relator_table::get_relator(m_relators[index]));
         
-        // The pointer to 
-        const Balanced_presentation *pointer;
-    };
+        // Return the sum
+        return relator_sum;
+    }
     
-    template<class Archive>
-    inline void Balanced_presentation::save(Archive &archive,unsigned int version) const
+    template <unsigned int Relators>
+    inline std::size_t Balanced_presentation::get_id_hash() const
     {
-        // Serialize all Relators
-        for(unsigned int index = 0; index < g_relators_count; ++index)
-            archive & m_relators[index];
+        // Define variable to hold the hash
+        boost::uint64_t hash = 0;
         
-        // Define the Intpoint
-        Intpoint intpoint;
+        // Mix in the ids, multiplying by an odd constant so each bit of an id reaches the high bits
+        for(unsigned int index = 0; index < get_relators_count<Relators>(); ++index)
+            hash = (hash ^ m_relators[index]) * 0x9E3779B97F4A7C15ull;
         
-        // Set pointer of intpoint
-        intpoint.pointer = m_parent;
-        
-        // Serialize the parent
-        archive & intpoint.number;
-        
-        // Serialize the parent's process
-        archive & m_parent_process;
+        // Fold the high bits, the best mixed, into the low bits
+        return static_cast<std::size_t>(hash ^ (hash >> 29));
     }
     
-    template<class Archive>
-    inline void Balanced_presentation::load(Archive &archive,unsigned int version)
+    template <unsigned int Relators>
+    inline void Balanced_presentation::copy_relators(const Balanced_presentation &rhs)
     {
-        // De-serialize all Relators
-        for(unsigned int index = 0; index < g_relators_count; ++index)
-            archive & m_relators[index];
-        
-        // Define the Intpoint
-        Intpoint intpoint;
-        
-        // De-serialize the parent
-        archive & intpoint.number;
-        
-        // Set the parent pointer
-        m_parent = intpoint.pointer;
-        
-        // De-serialize the parent's process
-        archive & m_parent_process;
+        // Loop over relators, copying their ids
+        for(unsigned int index = 0; index < get_relators_count<Relators>(); ++index)
+            m_relators[index] = rhs.m_relators[index];
+    }
+    
+    inline bool Balanced_presentation::operator<=(const Balanced_presentation &rhs) const
+    {
+        return !operator>(rhs);
+    }
+    
+    inline bool Balanced_presentation::operator>(const Balanced_presentation &rhs) const
+    {
+        return (rhs < *this);
+    }
+    
+    inline bool Balanced_presentation::operator>=(const Balanced_presentation &rhs) const
+    {
+        return !operator<(rhs);
     }
 }
 
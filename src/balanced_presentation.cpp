@@ -0,0 +1,214 @@
+//
+//  balanced_presentation.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 8/20/11.
+//
+//
+
+#include <vector>
+#include <algorithm>
+
+#include "globals.h"
+#include "letters.h"
+#include "relator.h"
+#include "relator_table.h"
+#include "slab_allocator.h"
+#include "balanced_presentation.h"
+
+
+namespace andrews_curtis
+{
+    // Utility function that returns the indexed Slab_allocator of Balanced_presentation records, constructed on first use once g_relators_count is set
+    static Slab_allocator &get_allocator();
+    
+    // Utility function to obtain the generator relabelings
+    const std::vector< std::vector<unsigned int> > &get_relabelings();
+    
+    // Utility function to build the generator relabelings
+    std::vector< std::vector<unsigned int> > build_relabelings();
+    
+    // Utility function to compare Relator pointers by the Relators
+    bool is_lesser_relator(const Relator *lhs, const Relator *rhs);
+    
+    void *Balanced_presentation::operator new(std::size_t /* size */)
+    {
+        // Note: the record size, not size, is that of the slab allocator's objects, see get_record_size()
+        return get_allocator().allocate();
+    }
+    
+    void Balanced_presentation::operator delete(void *balanced_presentation)
+    {
+        get_allocator().deallocate(balanced_presentation);
+    }
+    
+    unsigned long Balanced_presentation::get_allocations()
+    {
+        return get_allocator().get_allocations();
+    }
+    
+    void Balanced_presentation::release()
+    {
+        get_allocator().release();
+    }
+    
+    std::size_t Balanced_presentation::get_record_size()
+    {
+        return sizeof(Balanced_presentation) + (g_relators_count - 1) * sizeof(unsigned int);
+    }
+    
+    boost::uint32_t Balanced_presentation::get_link(const Balanced_presentation *balanced_presentation)
+    {
+        return balanced_presentation ? get_allocator().get_index(balanced_presentation) + 1 : 0;
+    }
+    
+    Balanced_presentation *Balanced_presentation::get_linked(boost::uint32_t link)
+    {
+        return link ? static_cast<Balanced_presentation*>(get_allocator().get_object(link - 1)) : 0;
+    }
+    
+    Slab_allocator &get_allocator()
+    {
+        // Construct the indexed Slab_allocator on first use, aligning records as their m_parent (Note: thread safe)
+        static Slab_allocator allocator(Balanced_presentation::get_record_size(), true, sizeof(boost::uint64_t));
+        
+        // Return the Slab_allocator
+        return allocator;
+    }
+    
+    void Balanced_presentation::canonicalize()
+    {
+        // Copy the Relators
+        std::vector<Relator> relators(g_relators_count);
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+            relators[index] = *get_relator(index);
+        
+        // Replace the copies with the canonical form
+        canonicalize(relators);
+        
+        // Replace the Relators with the interned canonical form
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+            m_relators[index] = Relator_table::intern(relators[index]);
+        
+        // Update m_key to the new Relators
+        update_key();
+    }
+    
+    void Balanced_presentation::canonicalize(std::vector<Relator> &relators)
+    {
+        // Obtain the generator relabelings, the first is the identity
+        const std::vector< std::vector<unsigned int> > &relabelings = get_relabelings();
+        
+        // In cyclic mode only the identity is used, see the header
+        size_t relabelings_count = g_is_cyclic ? 1 : relabelings.size();
+        
+        // Define the relabeled relators, their relabeled inverses, and the least form found
+        std::vector<Relator> forward(g_relators_count), backward(g_relators_count), least(g_relators_count);
+        
+        // Define the candidate form, as pointers into forward and backward, and the least form
+        std::vector<Relator*> candidate(g_relators_count), least_form(g_relators_count);
+        
+        // Loop over relabelings
+        for(size_t relabeling = 0; relabeling < relabelings_count; ++relabeling)
+        {
+            // Loop over relators
+            for(unsigned int index = 0; index < g_relators_count; ++index)
+            {
+                // Copy the Relator and its inverse
+                forward[index] = relators[index];
+                backward[index] = relators[index];
+                backward[index].invert();
+                
+                // In cyclic mode, rotate the inverse to its least rotation
+                if(g_is_cyclic)
+                    backward[index].make_cyclic();
+                
+                // Relabel both (Note: relabeling commutes with inversion)
+                if(relabeling)
+                {
+                    forward[index].relabel(&relabelings[relabeling][0]);
+                    backward[index].relabel(&relabelings[relabeling][0]);
+                }
+                
+                // Orient the Relator, taking the lesser of it and its inverse
+                candidate[index] = (backward[index] < forward[index]) ? &backward[index] : &forward[index];
+            }
+            
+            // Order the Relators
+            std::sort(candidate.begin(), candidate.end(), is_lesser_relator);
+            
+            // If this is the first candidate or it is less than the least form, it is the least form
+            if(!relabeling || std::lexicographical_compare(candidate.begin(), candidate.end(), least_form.begin(), least_form.end(), is_lesser_relator))
+            {
+                // Copy the candidate to least
+                for(unsigned int index = 0; index < g_relators_count; ++index)
+                {
+                    least[index] = *candidate[index];
+                    least_form[index] = &least[index];
+                }
+            }
+        }
+        
+        // Replace the Relators with the least form
+        relators.swap(least);
+    }
+    
+    const std::vector< std::vector<unsigned int> > &get_relabelings()
+    {
+        // Define the relabelings, built on first use (Note: initialization of a local static is thread safe)
+        static const std::vector< std::vector<unsigned int> > relabelings(build_relabelings());
+        
+        // Return the relabelings
+        return relabelings;
+    }
+    
+    std::vector< std::vector<unsigned int> > build_relabelings()
+    {
+        // Define the relabelings
+        std::vector< std::vector<unsigned int> > relabelings;
+        
+        // Obtain the number of relabeled generators
+        int count = (g_generators_count <= Balanced_presentation::s_max_relabeled_generators) ? g_generators_count : 0;
+        
+        // Define the permutation of the generators, starting with the identity
+        std::vector<int> permutation(count);
+        for(int generator = 0; generator < count; ++generator)
+            permutation[generator] = generator + 1;
+        
+        // Loop over permutations of the generators
+        do
+        {
+            // Loop over the generators to invert
+            for(unsigned int inverted = 0; inverted < (0x1u << count); ++inverted)
+            {
+                // Define the relabeling, the identity on unused bits
+                std::vector<unsigned int> relabeling(0x1 << g_bits_per_letter);
+                for(unsigned int bits = 0; bits < relabeling.size(); ++bits)
+                    relabeling[bits] = bits;
+                
+                // Map each generator and its inverse
+                for(int generator = 1; generator <= count; ++generator)
+                {
+                    // Obtain the image of generator
+                    int image = ((inverted >> (generator - 1)) & 0x1) ? -permutation[generator - 1] : permutation[generator - 1];
+                    
+                    // Map generator and its inverse
+                    relabeling[Letters::get_generator_bits(generator)] = Letters::get_generator_bits(image);
+                    relabeling[Letters::get_generator_bits(-generator)] = Letters::get_generator_bits(-image);
+                }
+                
+                // Add the relabeling
+                relabelings.push_back(relabeling);
+            }
+        }
+        while(std::next_permutation(permutation.begin(), permutation.end()));
+        
+        // Return the relabelings
+        return relabelings;
+    }
+    
+    bool is_lesser_relator(const Relator *lhs, const Relator *rhs)
+    {
+        return *lhs < *rhs;
+    }
+}
@@ -11,9 +11,9 @@
 
 
 #include <string>
+#include <vector>
 
-#include <boost/serialization/access.hpp>
-#include <boost/serialization/split_member.hpp>
+#include <boost/cstdint.hpp>
 
 
 namespace andrews_curtis
@@ -21,6 +21,7 @@ namespace andrews_curtis
     // Forward declarations
     class Relator;
     template <class T> class Binary_tree;
+    template <class T> class Hash_set;
     
     ///
     /// An instance of this class represents a balanced presentation. A balanced
@@ -30,6 +31,9 @@ namespace andrews_curtis
     class Balanced_presentation
     {
     public:
+        /// The most generators for which canonicalize() relabels generators
+        static const unsigned int s_max_relabeled_generators = 4;
+        
         ///
         /// Default constructor
         ///
@@ -41,11 +45,62 @@ namespace andrews_curtis
         ~Balanced_presentation();
         
         ///
-        /// Gets the parent of this Balanced_presentation
+        /// Allocates a Balanced_presentation from the slabs of Balanced_presentations,
+        /// see Slab_allocator. The allocation holds the whole record, the ids
+        /// of the relators included; so, a Balanced_presentation may only be
+        /// made with new.
+        ///
+        /// \param size The size of a Balanced_presentation, without the ids
+        ///             of all but its first relator
+        /// \return The allocated Balanced_presentation
+        ///
+        static void *operator new(std::size_t size);
+        
+        ///
+        /// Frees a Balanced_presentation to the slabs of Balanced_presentations
+        ///
+        /// \param balanced_presentation The Balanced_presentation to free
+        ///
+        static void operator delete(void *balanced_presentation);
+        
+        ///
+        /// Obtains the number of Balanced_presentations allocated from slabs by
+        /// all threads
+        ///
+        /// \return The number of allocations
+        ///
+        static unsigned long get_allocations();
+        
+        ///
+        /// Returns the size in bytes of a Balanced_presentation record, the
+        /// Balanced_presentation followed by the ids of all its relators
+        ///
+        /// \return The size in bytes of a Balanced_presentation record
+        ///
+        static std::size_t get_record_size();
+        
+        ///
+        /// Returns the slabs of Balanced_presentations to the system at once. No
+        /// heap Balanced_presentation may be in use and no thread may be
+        /// allocating.
         ///
-        /// \return The parent of this Balanced_presentation
+        static void release();
+        
+        ///
+        /// Returns a bool indicating if this Balanced_presentation has a parent
+        ///
+        /// \return A bool indicating if this Balanced_presentation has a parent
         ///
-        const Balanced_presentation*  const &get_parent() const;
+        bool has_parent() const;
+        
+        ///
+        /// Gets the parent of this Balanced_presentation. As the parent is held
+        /// as an index on the parent's process, this may only be called on the
+        /// parent's process.
+        ///
+        /// \return The parent of this Balanced_presentation, 0 if there is none
+        ///
+        const Balanced_presentation *get_parent() const;
         
         ///
         /// Obtains the process on which the parent of this instance should live
@@ -54,6 +109,41 @@ namespace andrews_curtis
         ///
         unsigned int get_parent_process() const;
         
+        ///
+        /// Obtains the handle of this Balanced_presentation, by which a child
+        /// made on another process refers to it as its parent
+        ///
+        /// \param process The process on which this Balanced_presentation lives
+        /// \return The handle of this Balanced_presentation
+        ///
+        boost::uint64_t get_handle(unsigned int process) const;
+        
+        ///
+        /// Obtains the handle of the parent of this Balanced_presentation, see
+        /// get_handle()
+        ///
+        /// \return The handle of the parent, 0 if there is none
+        ///
+        boost::uint64_t get_parent_handle() const;
+        
+        ///
+        /// Gets the Balanced_presentation with the passed handle. As the handle
+        /// holds an index on the process the Balanced_presentation lives on,
+        /// this may only be called on that process.
+        ///
+        /// \param handle The handle of the Balanced_presentation
+        /// \return The Balanced_presentation, 0 if handle is 0
+        ///
+        static const Balanced_presentation *get_handled(boost::uint64_t handle);
+        
+        ///
+        /// Sets the parent of this Balanced_presentation to the one with the
+        /// passed handle, see get_handle()
+        ///
+        /// \param parent The handle of the parent
+        ///
+        void set_parent(boost::uint64_t parent);
+        
         
         ///
         /// Gets the indicated relator of this Balanced_presentation
@@ -61,14 +151,23 @@ namespace andrews_curtis
         /// \param index The index of the relator to get
         /// \return The indicated relator
         ///
-        Relator *get_relator(int unsigned &index) const;
+        const Relator *get_relator(int unsigned &index) const;
+        
+        ///
+        /// Gets the Relator_table id of the indicated relator of this
+        /// Balanced_presentation
+        ///
+        /// \param index The index of the relator to get
+        /// \return The id of the indicated relator
+        ///
+        unsigned int get_relator_id(int unsigned &index) const;
         
         ///
         /// Sets the indicated relator of this Balanced_presentation
         ///
-        /// \param relator The new relator
+        /// \param relator The Relator_table id of the new relator
         /// \param index The index of the new Relator
-        void set_relator(Relator *relator, int unsigned &index);
+        void set_relator(unsigned int relator, int unsigned &index);
         
         ///
         /// Obtains the process on which this instance should live
@@ -77,6 +176,35 @@ namespace andrews_curtis
         ///
         unsigned int get_process() const;
         
+        ///
+        /// Obtains the process on which the presentation with the passed
+        /// relators should live, the same as get_process() once it is made
+        ///
+        /// \param relators The relators of the presentation
+        /// \return The process on which the presentation should live
+        ///
+        static unsigned int get_process(const std::vector<Relator> &relators);
+        
+        ///
+        /// Obtains the process on which a child of this instance, whose relator
+        /// at the passed index has the passed hash, should live. The child need
+        /// not be made, as the process only depends on the relators' hashes.
+        ///
+        /// \param index The index of the relator changed in the child
+        /// \param hash The hash of the relator at index in the child
+        /// \return The process on which the child should live
+        ///
+        unsigned int get_child_process(int unsigned &index, std::size_t hash) const;
+        
+        ///
+        /// Makes this instance a child of the passed Balanced_presentation, i.e.
+        /// copies its relators and makes it the parent of this instance
+        ///
+        /// \param parent The parent of this instance
+        /// \param parent_process The process on which parent lives
+        ///
+        void make_child_of(const Balanced_presentation &parent, unsigned int parent_process);
+        
         ///
         /// Returns a bool indicating if this presentation is trivial
         ///
@@ -84,6 +212,31 @@ namespace andrews_curtis
         ///
         bool is_trivial() const;
         
+        ///
+        /// Replaces this presentation with its canonical form, the least
+        /// presentation, relator by relator, obtainable by reordering the
+        /// relators, inverting relators and, for up to
+        /// s_max_relabeled_generators generators, permuting and inverting
+        /// generators. Each of these maps Andrews-Curtis moves to
+        /// Andrews-Curtis moves, so presentations with the same canonical
+        /// form are either all trivial or all not.
+        ///
+        /// In cyclic mode generators are not relabeled, as the moves on
+        /// a least rotation are not mapped to the moves on the least rot-
+        /// ation of its relabeling.
+        ///
+        void canonicalize();
+        
+        ///
+        /// Replaces the passed relators with the relators of the canonical form
+        /// of their presentation, see canonicalize(). Nothing is interned; so,
+        /// a child is canonicalized this way before it is sent to the process
+        /// on which it lives.
+        ///
+        /// \param relators The relators of the presentation to canonicalize
+        ///
+        static void canonicalize(std::vector<Relator> &relators);
+        
         ///
         /// Produces human readable string representation of this presentation
         ///
@@ -91,6 +244,36 @@ namespace andrews_curtis
         ///
         std::string to_string() const;
         
+        ///
+        /// Returns a hash of this presentation, of the Relator_table ids of its
+        /// relators. As ids are local to a process, so is the hash.
+        ///
+        /// \return A hash of this presentation
+        ///
+        std::size_t get_hash() const;
+        
+        ///
+        /// Obtains a 128 bit fingerprint of this presentation, of the words of
+        /// its relators, see Relator::add_to_fingerprint(). So, unlike the hash,
+        /// it is the same on every process and outlives Relator_table::clear().
+        ///
+        /// \param high The high 64 bits of the fingerprint
+        /// \param low The low 64 bits of the fingerprint
+        ///
+        void get_fingerprint(boost::uint64_t &high, boost::uint64_t &low) const;
+        
+        ///
+        /// Obtains the fingerprint a child of this instance, whose relator at
+        /// the passed index is the passed Relator, would have. The child need
+        /// not be made, nor the Relator interned.
+        ///
+        /// \param index The index of the relator changed in the child
+        /// \param relator The relator at index in the child
+        /// \param high The high 64 bits of the fingerprint
+        /// \param low The low 64 bits of the fingerprint
+        ///
+        void get_child_fingerprint(int unsigned &index, const Relator &relator, boost::uint64_t &high, boost::uint64_t &low) const;
+        
         ///
         /// Returns the length of this presentation
         ///
@@ -156,19 +339,119 @@ namespace andrews_curtis
         
         
     private:
-        /// The relators of this Balanced_presentation
-        Relator **m_relators;
+        //
+        // Updates m_key to the relators of this Balanced_presentation
+        //
+        void update_key();
+        
+        //
+        // Returns the number of relators, Relators if it is not 0 and otherwise
+        // g_relators_count. The loops below are instantiated for 2, 3 and 4
+        // relators, for which the compiler sees the count as a constant and
+        // unrolls them, and for 0, the generic path.
+        //
+        // \return The number of relators
+        //
+        template <unsigned int Relators> static unsigned int get_relators_count();
+        
+        //
+        // Returns the sum of the hashes of the relators
+        //
+        // \return The sum of the hashes of the relators
+        //
+        template <unsigned int Relators> std::size_t get_relator_sum() const;
+        
+        //
+        // Returns a hash of the ids of the relators
+        //
+        // \return A hash of the ids of the relators
+        //
+        template <unsigned int Relators> std::size_t get_id_hash() const;
+        
+        //
+        // Copies the relators of the passed Balanced_presentation
+        //
+        // \param rhs The Balanced_presentation to copy the relators of
+        //
+        template <unsigned int Relators> void copy_relators(const Balanced_presentation &rhs);
+        
+        //
+        // Implementation of ==
+        //
+        // \param rhs The Balanced_presentation to compare to
+        // \return The bool indicating the result of ==
+        //
+        template <unsigned int Relators> bool is_equal(const Balanced_presentation &rhs) const;
+        
+        //
+        // Implementation of <
+        //
+        // \param rhs The Balanced_presentation to compare to
+        // \return The bool indicating the result of <
+        //
+        template <unsigned int Relators> bool is_less(const Balanced_presentation &rhs) const;
+        
+        //
+        // Returns the link to the passed Balanced_presentation, its index in the
+        // slabs of Balanced_presentations plus one, 0 linking to none
+        //
+        // \param balanced_presentation The Balanced_presentation, may be 0
+        // \return The link to balanced_presentation
+        //
+        static boost::uint32_t get_link(const Balanced_presentation *balanced_presentation);
+        
+        //
+        // Returns the Balanced_presentation the passed link links to
+        //
+        // \param link The link, see get_link()
+        // \return The linked Balanced_presentation, 0 if link is 0
+        //
+        static Balanced_presentation *get_linked(boost::uint32_t link);
+        
+        //
+        // Gets the left subtree of this Balanced_presentation's binary search tree
+        //
+        // \return The left subtree, 0 if there is none
+        //
+        Balanced_presentation *get_left() const;
+        
+        //
+        // Gets the right subtree of this Balanced_presentation's binary search tree
+        //
+        // \return The right subtree, 0 if there is none
+        //
+        Balanced_presentation *get_right() const;
         
-        /// The parent of this Balanced_presentation
-        const Balanced_presentation *m_parent;
+        //
+        // Sets the left subtree of this Balanced_presentation's binary search tree
+        //
+        // \param left The left subtree
+        //
+        void set_left(Balanced_presentation *left);
         
-        /// The process of the parent of this Balanced_presentation
-        unsigned int m_parent_process;
+        //
+        // Sets the right subtree of this Balanced_presentation's binary search tree
+        //
+        // \param right The right subtree
+        //
+        void set_right(Balanced_presentation *right);
+        
+        /// Note: The parent is held as a handle, the process of the parent in
+        /// the high 32 bits and the link to it on that process in the low 32
+        /// bits, rather than as a 64 bit pointer and a separate process. In
+        /// frozen mode the low 32 bits are instead the parent's frozen index,
+        /// see Frozen_set::find(), as the parent is deleted once expanded.
+        
+        /// The handle of the parent of this Balanced_presentation, 0 if none
+        boost::uint64_t m_parent;
         
         
         /// Indicate Binary_tree<Balanced_presentation> is a friend
         friend class Binary_tree<Balanced_presentation>;
         
+        /// Indicate Hash_set<Balanced_presentation> is a friend
+        friend class Hash_set<Balanced_presentation>;
+        
         /// Note: Having the Balanced_presentation be a Balanced_presentation and
         /// a node in a BST allows for saving of one pointer per instance. If all
         /// Balanced_presentations were stored in an external BST class, then for
@@ -179,36 +462,39 @@ namespace andrews_curtis
         /// we have 10-100 million Balanced_presentations, this will save us from
         /// 80-800 MB or more! (One 64 bit pointer per Balanced_presentation.)
         
+        /// Note: The subtrees are held as 32 bit links, indices into the slabs
+        /// of Balanced_presentations, rather than as 64 bit pointers. This
+        /// saves another 8 bytes per Balanced_presentation.
+        
         /// Left subtree of this Balanced_presentation's binary search tree
-        Balanced_presentation *m_left;
+        boost::uint32_t m_left;
         
         /// Right subtree of this Balanced_presentation's binary search tree
-        Balanced_presentation *m_right;
+        boost::uint32_t m_right;
         
+        /// The prefix key of this Balanced_presentation, the high 32 bits of
+        /// the hash of the ids of its relators, compared before the ids
+        boost::uint32_t m_key;
         
-        // Indicate boost::serialization::access is a friend for serialization
-        friend class boost::serialization::access;
+        /// Note: As the relators are interned in the Relator_table, each is held
+        /// as a 32 bit id rather than a 64 bit pointer, halving the memory the
+        /// relators of a Balanced_presentation take. Also, as equal relators
+        /// have equal ids, comparing presentations only compares integers.
         
-        //
-        // This method serializes this instance to the passed Archive using the
-        // specified verison of serialization
-        //
-        // \param archive The archive to serialize to
-        // \param version The version of serialization to use
-        //
-        template<class Archive> void save(Archive &archive,unsigned int version) const;
+        /// Note: The ids are held at the end of the Balanced_presentation, which
+        /// operator new allocates with room for g_relators_count ids. So, the
+        /// whole record is one allocation, of at most a cache line for up to
+        /// 11 relators, rather than a Balanced_presentation and an array of ids.
+        
+        /// The Relator_table ids of the relators of this Balanced_presentation,
+        /// the first of g_relators_count
+        unsigned int m_relators[1];
         
-        //
-        // This method deserializes this instance to the passed Archive using the
-        // specified verison of deserialization
-        //
-        // \param archive The archive to deserialize from
-        // \param version The version of deserialization to use
-        //
-        template<class Archive> void load(Archive &archive,unsigned int version);
         
-        // Generates code which invokes the save or load in the aropos situation
-        BOOST_SERIALIZATION_SPLIT_MEMBER()
+        /// Note: A Balanced_presentation is not serialized. A child is sent to
+        /// the process it lives on as the words of its relators, see
+        /// Balanced_presentation_nursery::Children, and interned there only if
+        /// it is new; a derivation is followed back by the handles of parents.
     };
 }
 
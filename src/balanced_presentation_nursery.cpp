@@ -9,132 +9,338 @@
 
 #include "globals.h"
 #include "relator.h"
+#include "relator_table.h"
 #include "balanced_presentation.h"
 #include "balanced_presentation_nursery.h"
 
 
 namespace andrews_curtis
 {
-    // Utility function that added Relators to the passed presentation
-    static void populate_child(Balanced_presentation *balanced_presentation);
+    // Typedefs
+    typedef Balanced_presentation_nursery::Move Move;
     
-    // Utility function that creates children resulting form Type I moves: [r => r^-1]
-    static void create_type_one_children(const Balanced_presentation *bp,std::list<Balanced_presentation*> &children);
+    // Utility function that creates the moves of all types
+    template <unsigned int Relators> static void create_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves);
     
-    // Utility function that creates children resulting form Type II moves: [r => g*r*g^-1]
-    static void create_type_two_children(const Balanced_presentation *bp,std::list<Balanced_presentation*> &children);
+    // Utility function that creates Type I moves: [r => r^-1]
+    template <unsigned int Relators> static void create_type_one_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves);
     
-    // Utility function that creates children resulting form Type III moves: [r => r*s]
-    static void create_type_three_children(const Balanced_presentation *bp,std::list<Balanced_presentation*> &children);
+    // Utility function that creates Type II moves: [r => g*r*g^-1]
+    template <unsigned int Relators> static void create_type_two_moves(const Balanced_presentation *bp,std::vector<Move> &moves);
     
+    // Utility function that creates Type III moves: [r => r*s]
+    template <unsigned int Relators> static void create_type_three_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves);
     
-    std::list<Balanced_presentation*> Balanced_presentation_nursery::get_children(const Balanced_presentation *bp)
+    // Utility function that appends a move to moves
+    static void push_move(std::vector<Move> &moves,unsigned int type,unsigned int orientation,unsigned int index,int operand,size_t rotation);
+    
+    
+    std::list<Balanced_presentation*> Balanced_presentation_nursery::get_children(const Balanced_presentation *bp,bool is_oriented)
     {
+        // Note: A move changes exactly one relator, so a child shares the ids of
+        //       its other relators with bp, copying only the ids. The changed
+        //       relator is made in a scratch Relator, reused for all children
+        //       so that a long relator allocates its Blocks once per parent, and
+        //       then interned, which copies it only if it is new.
+        
         // Create list to return
         std::list<Balanced_presentation*> children;
         
-        // Create children resulting from Type I moves: [r => r^-1]
-        create_type_one_children(bp,children);
+        // Obtain the moves of bp
+        std::vector<Move> moves;
+        get_moves(bp,is_oriented,moves);
         
-        // Create children resulting from Type II moves: [r => g*r*g^-1]
-        create_type_two_children(bp,children);
+        // Obtain the process on which bp lives
+        unsigned int parent_process = bp->get_process();
         
-        // Create children resulting from Type III moves: [r => r*s]
-        create_type_three_children(bp,children);
+        // Define the scratch Relators moves are made in
+        Relator relator;
+        Relator scratch;
+        
+        // Loop over moves, making the child of each
+        for(std::vector<Move>::const_iterator itr = moves.begin(); itr != moves.end(); ++itr)
+            children.push_back(make_child(bp,parent_process,*itr,relator,scratch));
         
         // Return children
         return children;
     }
     
-    void populate_child(Balanced_presentation *balanced_presentation)
+    void Balanced_presentation_nursery::get_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves)
     {
-        // Loop over relators
-        for(unsigned int r_index = 0; r_index < g_relators_count; ++r_index)
+        // Create moves, specialized on the number of relators (Note: the
+        // generic path, 0, reads the number of relators from g_relators_count)
+        switch(g_relators_count)
         {
-            // Put a new Relator in the Balanced_presentation
-            balanced_presentation->set_relator(new Relator(), r_index);
+            case 2: create_moves<2>(bp,is_oriented,moves); break;
+            case 3: create_moves<3>(bp,is_oriented,moves); break;
+            case 4: create_moves<4>(bp,is_oriented,moves); break;
+            default: create_moves<0>(bp,is_oriented,moves); break;
         }
     }
     
-    void create_type_one_children(const Balanced_presentation *bp,std::list<Balanced_presentation*> &children)
+    std::size_t Balanced_presentation_nursery::get_hash(const Balanced_presentation *bp,const Move &move)
     {
-        // Loop over Relator's
-        for(unsigned int index = 0; index < g_relators_count; ++index)
+        // Obtain the index of the relator changed by move
+        unsigned int index = move.m_index;
+        
+        // Obtain the relator changed by move
+        const Relator *relator = bp->get_relator(index);
+        
+        // Type I moves: [r => r^-1], the hash of r^-1 is cached
+        if(1 == move.m_type)
+            return relator->get_inverse_hash();
+        
+        // Type II moves: [r => g*r*g^-1]
+        if(2 == move.m_type)
+            return relator->get_conjugate_hash(move.m_operand);
+        
+        // Type III moves: [r => r*s]
+        unsigned int operand = move.m_operand;
+        return relator->get_product_hash(bp->get_relator(operand));
+    }
+    
+    void Balanced_presentation_nursery::make_relator(const Balanced_presentation *bp,const Move &move,Relator &relator,Relator &scratch)
+    {
+        // Obtain the index of the relator changed by move
+        unsigned int index = move.m_index;
+        
+        // Copy the Relator at index into relator
+        relator = *bp->get_relator(index);
+        
+        // Type I moves: [r => r^-1]
+        if(1 == move.m_type)
         {
-            // New up a Balanced_presentation
-            Balanced_presentation *balanced_presentation = new Balanced_presentation();
+            // Invert the Relator
+            relator.invert();
             
-            // Populate balanced_presentation with Relators
-            populate_child(balanced_presentation);
+            // In cyclic mode, rotate the inverse to its least rotation
+            if(g_is_cyclic)
+                relator.make_cyclic();
+        }
+        // Type II moves: [r => g*r*g^-1]
+        else if(2 == move.m_type)
+        {
+            // Conjugate the Relator with generator m_operand
+            relator.conjugate(move.m_operand);
+        }
+        // Type III moves: [r => r*s]
+        else
+        {
+            // Copy the Relator at m_operand into scratch
+            unsigned int operand = move.m_operand;
+            scratch = *bp->get_relator(operand);
             
-            // Copy bp to balanced_presentation
-            *balanced_presentation = *bp;
+            // Orient the Relators, as an inversion would (Note: cyclic mode rotates the inverses)
+            for(unsigned int orientation = 0; orientation < 2; ++orientation)
+            {
+                // Obtain the Relator to orient
+                Relator *oriented = orientation ? &scratch : &relator;
+                
+                // Only invert the Relators flagged by m_orientation
+                if(!((move.m_orientation >> orientation) & 0x1))
+                    continue;
+                
+                // Invert the Relator
+                oriented->invert();
+                
+                // In cyclic mode, rotate the inverse to its least rotation
+                if(g_is_cyclic)
+                    oriented->make_cyclic();
+            }
+            
+            // Rotate the Relator at m_operand by m_rotation
+            scratch.rotate(move.m_rotation);
             
-            // Invert Relator at index
-            balanced_presentation->get_relator(index)->invert();
+            // Multiply the Relator at index on the right by the rotated Relator at m_operand
+            relator.multiply(&scratch);
             
-            // Put balanced_presentation into children
-            children.push_back(balanced_presentation);
+            // In cyclic mode, cyclically reduce and rotate the product to its least rotation
+            if(g_is_cyclic)
+                relator.make_cyclic();
         }
     }
     
-    void create_type_two_children(const Balanced_presentation *bp,std::list<Balanced_presentation*> &children)
+    Balanced_presentation *Balanced_presentation_nursery::make_child(const Balanced_presentation *bp,unsigned int parent_process,const Move &move,Relator &relator,Relator &scratch)
+    {
+        // Make the relator changed by move
+        make_relator(bp,move,relator,scratch);
+        
+        // New up a Balanced_presentation
+        Balanced_presentation *balanced_presentation = new Balanced_presentation();
+        
+        // Make balanced_presentation a child of bp
+        balanced_presentation->make_child_of(*bp,parent_process);
+        
+        // Intern the relator as Relator at m_index
+        unsigned int index = move.m_index;
+        balanced_presentation->set_relator(Relator_table::intern(relator), index);
+        
+        // Return balanced_presentation
+        return balanced_presentation;
+    }
+    
+    void Balanced_presentation_nursery::make_relators(const Balanced_presentation *bp,const Move &move,std::vector<Relator> &relators,Relator &scratch)
+    {
+        // Make room for the relators of the child
+        relators.resize(g_relators_count);
+        
+        // Obtain the index of the relator changed by move
+        unsigned int index = move.m_index;
+        
+        // Copy the other Relators of bp
+        for(unsigned int other = 0; other < g_relators_count; ++other)
+        {
+            if(other != index)
+                relators[other] = *bp->get_relator(other);
+        }
+        
+        // Make the relator changed by move in place
+        make_relator(bp,move,relators[index],scratch);
+    }
+    
+    void Balanced_presentation_nursery::Children::push_back(const std::vector<Relator> &relators,boost::uint64_t parent)
+    {
+        // Append the Relators and the handle of the parent
+        m_relators.insert(m_relators.end(),relators.begin(),relators.end());
+        m_parents.push_back(parent);
+    }
+    
+    std::size_t Balanced_presentation_nursery::Children::size() const
+    {
+        return m_parents.size();
+    }
+    
+    void Balanced_presentation_nursery::Children::get_fingerprint(std::size_t child,boost::uint64_t &high,boost::uint64_t &low) const
+    {
+        // Start from the fingerprint of no relators
+        high = 0;
+        low = 0;
+        
+        // Mix in the Relators of the child in turn
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+            m_relators[child * g_relators_count + index].add_to_fingerprint(high,low);
+    }
+    
+    void Balanced_presentation_nursery::Children::clear()
+    {
+        // Swap with empty deques, as clear() may keep their memory
+        std::deque<Relator>().swap(m_relators);
+        std::deque<boost::uint64_t>().swap(m_parents);
+    }
+    
+    void Balanced_presentation_nursery::Children::swap(Children &children)
+    {
+        m_relators.swap(children.m_relators);
+        m_parents.swap(children.m_parents);
+    }
+    
+    template <unsigned int Relators>
+    void create_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves)
     {
+        // Create Type I moves: [r => r^-1]
+        create_type_one_moves<Relators>(bp,is_oriented,moves);
+        
+        // Create Type II moves: [r => g*r*g^-1]
+        create_type_two_moves<Relators>(bp,moves);
+        
+        // Create Type III moves: [r => r*s]
+        create_type_three_moves<Relators>(bp,is_oriented,moves);
+    }
+    
+    template <unsigned int Relators>
+    void create_type_one_moves(const Balanced_presentation * /* bp */,bool is_oriented,std::vector<Move> &moves)
+    {
+        // Up to inverting relators an inverse is the Relator itself, see create_type_three_moves
+        if(is_oriented)
+            return;
+        
+        // Obtain the number of relators
+        const unsigned int relators = Relators ? Relators : g_relators_count;
+        
+        // Loop over Relator's
+        for(unsigned int index = 0; index < relators; ++index)
+            push_move(moves,1,0,index,0,0);
+    }
+    
+    template <unsigned int Relators>
+    void create_type_two_moves(const Balanced_presentation * /* bp */,std::vector<Move> &moves)
+    {
+        // In cyclic mode a conjugate is the Relator itself, see create_type_three_moves
+        if(g_is_cyclic)
+            return;
+        
+        // Obtain the number of relators and generators, equal as the presentation is balanced
+        const unsigned int relators = Relators ? Relators : g_relators_count;
+        const int generators = Relators ? Relators : g_generators_count;
+        
         // Loop over relators
-        for(unsigned int r_index = 0; r_index < g_relators_count; ++r_index)
+        for(unsigned int r_index = 0; r_index < relators; ++r_index)
         {
             // Loop over all generators (Note: They're 1 based, n and -n are inverses)
-            for(int g_index = -g_generators_count; g_index <= g_generators_count; ++g_index)
+            for(int g_index = -generators; g_index <= generators; ++g_index)
             {
                 // There is no generator 0; so, skip it
                 if(0 == g_index)
                     continue;
                 
-                // New up a Balanced_presentation
-                Balanced_presentation *balanced_presentation = new Balanced_presentation();
-                
-                // Populate balanced_presentation with Relators
-                populate_child(balanced_presentation);
-                
-                // Copy bp to balanced_presentation
-                *balanced_presentation = *bp;
-                
-                // Conjugate Relator at r_index with generator g_index
-                balanced_presentation->get_relator(r_index)->conjugate(g_index);
-                
-                // Put balanced_presentation into children
-                children.push_back(balanced_presentation);
+                // Conjugate the Relator at r_index with generator g_index
+                push_move(moves,2,0,r_index,g_index,0);
             }
         }
     }
     
-    void create_type_three_children(const Balanced_presentation *bp,std::list<Balanced_presentation*> &children)
+    template <unsigned int Relators>
+    void create_type_three_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves)
     {
+        // Obtain the number of orientations of the two relators to multiply
+        // (Note: Up to inverting relators type I moves are dropped, multiplying
+        // with either relator inverted recovers a type I move then a type III)
+        unsigned int orientations = is_oriented ? 4 : 1;
+        
+        // Obtain the number of relators
+        const unsigned int relators = Relators ? Relators : g_relators_count;
+        
         // Loop over relators acted on
-        for(unsigned int index1 = 0; index1 < g_relators_count; ++index1)
+        for(unsigned int index1 = 0; index1 < relators; ++index1)
         {
             // Loop over relators acting on
-            for(unsigned int index2 = 0; index2 < g_relators_count; ++index2)
+            for(unsigned int index2 = 0; index2 < relators; ++index2)
             {
                 // The move r_index1 => r_index1*r_index2 only occurs for index1 != index2
                 if(index1 == index2)
                     continue;
                 
-                // New up a Balanced_presentation
-                Balanced_presentation *balanced_presentation = new Balanced_presentation();
-                
-                // Populate balanced_presentation with Relators
-                populate_child(balanced_presentation);
-                
-                // Copy bp to balanced_presentation
-                *balanced_presentation = *bp;
-                
-                // Multiply Relator at index1 on the right by Relator at index2
-                balanced_presentation->get_relator(index1)->multiply(balanced_presentation->get_relator(index2));
+                // Obtain the number of rotations of Relator at index2 to multiply by
+                // (Note: Cyclic mode drops type II moves; rotating the cyclically
+                // reduced r_index2 recovers r_index1 => r_index1*(g*r_index2*g^-1)
+                // only where g is a boundary letter of r_index2, the conjugate by
+                // any other g is not a rotation and so is not a move in this mode)
+                size_t rotations = g_is_cyclic ? bp->get_relator(index2)->get_length() : 1;
                 
-                // Put balanced_presentation into children
-                children.push_back(balanced_presentation);
+                // Loop over orientations, bit 0 inverts Relator at index1 and bit 1 Relator at index2
+                for(unsigned int orientation = 0; orientation < orientations; ++orientation)
+                {
+                    // Loop over rotations of Relator at index2, there is at least one
+                    for(size_t rotation = 0; (rotation < rotations) || !rotation; ++rotation)
+                        push_move(moves,3,orientation,index1,index2,rotation);
+                }
             }
         }
     }
+    
+    void push_move(std::vector<Move> &moves,unsigned int type,unsigned int orientation,unsigned int index,int operand,size_t rotation)
+    {
+        // Define the move
+        Move move;
+        
+        // Set the fields of the move
+        move.m_type = static_cast<unsigned char>(type);
+        move.m_orientation = static_cast<unsigned char>(orientation);
+        move.m_index = static_cast<unsigned short>(index);
+        move.m_operand = operand;
+        move.m_rotation = static_cast<unsigned int>(rotation);
+        
+        // Append the move
+        moves.push_back(move);
+    }
 }
@@ -11,6 +11,14 @@
 
 
 #include <list>
+#include <deque>
+#include <vector>
+#include <cstddef>
+
+#include <boost/cstdint.hpp>
+#include <boost/serialization/deque.hpp>
+
+#include "relator.h"
 
 
 namespace andrews_curtis
@@ -25,6 +33,94 @@ namespace andrews_curtis
     class Balanced_presentation_nursery
     {
     public:
+        ///
+        /// A Move identifies a child of a Balanced_presentation by the Andrews
+        /// Curtis move taking the Balanced_presentation to the child. As a move
+        /// changes only one relator, the child is its parent plus a Move.
+        ///
+        struct Move
+        {
+            /// The type of the move, 1 [r => r^-1], 2 [r => g*r*g^-1] or 3 [r => r*s]
+            unsigned char m_type;
+            
+            /// For a type III move, bit 0 inverts the relator at m_index and bit 1 the relator at m_operand
+            unsigned char m_orientation;
+            
+            /// The index of the relator changed by the move
+            unsigned short m_index;
+            
+            /// For a type II move the generator g, for a type III move the index of the relator s
+            int m_operand;
+            
+            /// For a type III move, the rotation of the relator s
+            unsigned int m_rotation;
+        };
+        
+        ///
+        /// A Children holds the children made on one process that live on
+        /// another. As the Relator_table ids of a process are local to it, a
+        /// child is held as the words of its relators and the handle of its
+        /// parent; so, the process making a child does not intern its relators,
+        /// only the process the child lives on does, once it is found new.
+        ///
+        struct Children
+        {
+            /// The Relators of the children, g_relators_count a child
+            std::deque<Relator> m_relators;
+            
+            /// The handles of the parents of the children, one a child
+            std::deque<boost::uint64_t> m_parents;
+            
+            ///
+            /// Appends a child
+            ///
+            /// \param relators The relators of the child
+            /// \param parent The handle of the parent of the child
+            ///
+            void push_back(const std::vector<Relator> &relators,boost::uint64_t parent);
+            
+            ///
+            /// Returns the number of children
+            ///
+            /// \return The number of children
+            ///
+            std::size_t size() const;
+            
+            ///
+            /// Obtains the fingerprint of the indicated child, the fingerprint
+            /// Balanced_presentation::get_fingerprint() obtains once it is made
+            ///
+            /// \param child The index of the child
+            /// \param high The high 64 bits of the fingerprint
+            /// \param low The low 64 bits of the fingerprint
+            ///
+            void get_fingerprint(std::size_t child,boost::uint64_t &high,boost::uint64_t &low) const;
+            
+            ///
+            /// Removes all children, returning their memory
+            ///
+            void clear();
+            
+            ///
+            /// Swaps the children with those of the passed Children
+            ///
+            /// \param children The Children to swap with
+            ///
+            void swap(Children &children);
+            
+            ///
+            /// Serializes the children to or from the passed Archive
+            ///
+            /// \param archive The archive to serialize to or from
+            /// \param version The version of serialization to use
+            ///
+            template<class Archive> void serialize(Archive &archive,unsigned int /* version */)
+            {
+                archive & m_relators;
+                archive & m_parents;
+            }
+        };
+        
         ///
         /// Returns a list of Balanced_presentation's each one of which is a child of
         /// the passed Balanced_presentation with respect to Andrews Curtis moves.
@@ -33,10 +129,78 @@ namespace andrews_curtis
         /// controlled by the caller, ie the caller should call delete on each when they
         /// are no longer needed.
         ///
+        /// If is_oriented is true, the children are those of the passed Balanced_presentation
+        /// up to inverting relators, as used in canonical mode. Then the type I moves, which
+        /// only invert relators, are dropped, while the type III moves multiply relators and
+        /// their inverses by relators and their inverses.
+        ///
         /// \param bp The Balanced_presentation to find the children of
+        /// \param is_oriented A bool indicating if relators are identified with their inverses
         /// \return The children of the passed Balanced_presentation
         ///
-        static std::list<Balanced_presentation*> get_children(const Balanced_presentation *bp);
+        static std::list<Balanced_presentation*> get_children(const Balanced_presentation *bp,bool is_oriented = false);
+        
+        ///
+        /// Obtains the Moves taking the passed Balanced_presentation to its children,
+        /// in the order get_children() returns the children. See get_children() for
+        /// is_oriented.
+        ///
+        /// \param bp The Balanced_presentation to find the Moves of
+        /// \param is_oriented A bool indicating if relators are identified with their inverses
+        /// \param moves The vector the Moves are appended to
+        ///
+        static void get_moves(const Balanced_presentation *bp,bool is_oriented,std::vector<Move> &moves);
+        
+        ///
+        /// Returns the hash of the relator the passed Move puts at m_index, from the
+        /// cached hashes of the relators of bp and without making the relator. Only
+        /// Moves with m_orientation and m_rotation 0 are supported, and in cyclic
+        /// mode the returned hash is of the relator before it is rotated to its
+        /// least rotation.
+        ///
+        /// \param bp The Balanced_presentation to apply the Move to
+        /// \param move The Move to apply
+        /// \return The hash of the relator made by the Move
+        ///
+        static std::size_t get_hash(const Balanced_presentation *bp,const Move &move);
+        
+        ///
+        /// Makes the relator the passed Move puts at m_index in the passed Relator,
+        /// using the passed scratch Relator for the relator s of a type III move.
+        ///
+        /// \param bp The Balanced_presentation to apply the Move to
+        /// \param move The Move to apply
+        /// \param relator The Relator the relator made by the Move is made in
+        /// \param scratch The Relator the relator s of a type III move is made in
+        ///
+        static void make_relator(const Balanced_presentation *bp,const Move &move,Relator &relator,Relator &scratch);
+        
+        ///
+        /// Makes the child the passed Move takes the passed Balanced_presentation to.
+        /// The lifetime of the returned Balanced_presentation should be controlled by
+        /// the caller, see get_children().
+        ///
+        /// \param bp The Balanced_presentation to apply the Move to
+        /// \param parent_process The process on which bp lives
+        /// \param move The Move to apply
+        /// \param relator The Relator the relator made by the Move is made in
+        /// \param scratch The Relator the relator s of a type III move is made in
+        /// \return The child of bp
+        ///
+        static Balanced_presentation *make_child(const Balanced_presentation *bp,unsigned int parent_process,const Move &move,Relator &relator,Relator &scratch);
+        
+        ///
+        /// Makes the relators of the child the passed Move takes the passed
+        /// Balanced_presentation to, as words. Unlike make_child() nothing is
+        /// interned, so a child is made this way before it is sent to the
+        /// process on which it lives, see Children.
+        ///
+        /// \param bp The Balanced_presentation to apply the Move to
+        /// \param move The Move to apply
+        /// \param relators The Relators the relators of the child are made in
+        /// \param scratch The Relator the relator s of a type III move is made in
+        ///
+        static void make_relators(const Balanced_presentation *bp,const Move &move,std::vector<Relator> &relators,Relator &scratch);
     };
 }
 
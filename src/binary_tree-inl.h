@@ -10,6 +10,10 @@
 #define Andrews_Curtis_Conjecture_binary_tree_inl_h
 
 
+#include <utility>
+#include <algorithm>
+
+
 namespace andrews_curtis
 {    
     // Define Binary_tree<T>::s_root
@@ -28,6 +32,18 @@ namespace andrews_curtis
     template <class T>
     unsigned long Binary_tree<T>::m_length = 0;
     
+    // Define Binary_tree<T>::m_depth_bound
+    template <class T>
+    unsigned long Binary_tree<T>::m_depth_bound = 0;
+    
+    // Define Binary_tree<T>::m_bound_size
+    template <class T>
+    double Binary_tree<T>::m_bound_size = 4.0 / 3.0;
+    
+    // Define Binary_tree<T>::m_rebuilds
+    template <class T>
+    unsigned long Binary_tree<T>::m_rebuilds = 0;
+    
     
     template <class T>
     inline T *Binary_tree<T>::insert(T *element)
@@ -51,70 +67,99 @@ namespace andrews_curtis
             return 0;
         }
         
+        // Define the path to element and its depth, the number of elements on it
+        T *path[s_max_depth];
+        unsigned int depth = 0;
+        
         // Set the current element to s_root
         T *current_element = s_root;
         
-        // Loop forever
+        // Loop until element is inserted
         while(true)
         {
             // If element == current_element, element is already there
             if(*element == *current_element)
                 return current_element;
             
+            // Add current_element to the path
+            path[depth++] = current_element;
+            
             // If element < current_element
             if(*element < *current_element)
             {
                 // If current_element has no left child
-                if(!current_element->m_left)
+                if(!current_element->get_left())
                 {
                     // Insert element as the left child of current_element
-                    current_element->m_left = element;
+                    current_element->set_left(element);
                     
-                    // Increment m_size
-                    ++m_size;
-                    
-                    // Increment m_length
-                    m_length += element->get_length();
-                            
-                    // Return 0 indicating the element was inserted
-                    return 0;
-                }
-                else
-                {
-                    // If current_element has a left child, use it as current_element
-                    current_element = current_element->m_left;
-                    
-                    // Continue to while
-                    continue;
+                    // Break out of while
+                    break;
                 }
+                
+                // If current_element has a left child, use it as current_element
+                current_element = current_element->get_left();
             }
             else
             {
                 // If current_element has no right child
-                if(!current_element->m_right)
+                if(!current_element->get_right())
                 {
                     // Insert element as the right child of current_element
-                    current_element->m_right = element;
-                    
-                    // Increment m_size
-                    ++m_size;
-                    
-                    // Increment m_length
-                    m_length += element->get_length();
-                            
-                    // Return 0 indicating the element was inserted
-                    return 0;
-                }
-                else
-                {
-                    // If current_element has a right child, use it as current_element
-                    current_element = current_element->m_right;
+                    current_element->set_right(element);
                     
-                              // Continue to while
-                    continue;
+                    // Break out of while
+                    break;
                 }
+                
+                // If current_element has a right child, use it as current_element
+                current_element = current_element->get_right();
             }
         }
+        
+        // Increment m_size
+        ++m_size;
+        
+        // Increment m_length
+        m_length += element->get_length();
+        
+        // Raise the depth bound, floor(log_{4/3}(m_size)), as m_size grows
+        while(m_bound_size <= m_size)
+        {
+            ++m_depth_bound;
+            m_bound_size *= 4.0 / 3.0;
+        }
+        
+        // If element is deeper than the bound, rebuild the subtree of a scapegoat
+        if(depth > m_depth_bound)
+            rebalance(element, path, depth);
+        
+        // Return 0 indicating the element was inserted
+        return 0;
+    }
+    
+    template <class T>
+    inline T *Binary_tree<T>::find(const T *element)
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Set the current element to s_root
+        T *current_element = s_root;
+        
+        // Loop until we fall off the tree
+        while(current_element)
+        {
+            // If element == current_element, element is there
+            if(*element == *current_element)
+                return current_element;
+            
+            // Descend to the left subtree if element < current_element, else to the right
+            current_element = (*element < *current_element) ? current_element->get_left() : current_element->get_right();
+        }
+        
+        // Return 0 indicating the element is not there
+        return 0;
     }
     
     template <class T>
@@ -137,6 +182,116 @@ namespace andrews_curtis
         return m_length;
     }
     
+    template <class T>
+    unsigned long Binary_tree<T>::height()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Define the height
+        unsigned long height = 0;
+        
+        // Define the stack of elements to visit and their depths
+        std::vector< std::pair<T*, unsigned long> > stack;
+        if(s_root)
+            stack.push_back(std::make_pair(s_root, 1ul));
+        
+        // Loop over the elements, the height is the greatest depth
+        while(!stack.empty())
+        {
+            // Pop the next element
+            std::pair<T*, unsigned long> next = stack.back();
+            stack.pop_back();
+            
+            // Raise the height to its depth
+            height = std::max(height, next.second);
+            
+            // Push its subtrees
+            if(next.first->get_left())
+                stack.push_back(std::make_pair(next.first->get_left(), next.second + 1));
+            if(next.first->get_right())
+                stack.push_back(std::make_pair(next.first->get_right(), next.second + 1));
+        }
+        
+        // Return the height
+        return height;
+    }
+    
+    template <class T>
+    unsigned long Binary_tree<T>::depths()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Define the sum of the depths
+        unsigned long depths = 0;
+        
+        // Define the stack of elements to visit and their depths
+        std::vector< std::pair<T*, unsigned long> > stack;
+        if(s_root)
+            stack.push_back(std::make_pair(s_root, 1ul));
+        
+        // Loop over the elements, summing their depths
+        while(!stack.empty())
+        {
+            // Pop the next element
+            std::pair<T*, unsigned long> next = stack.back();
+            stack.pop_back();
+            
+            // Add its depth
+            depths += next.second;
+            
+            // Push its subtrees
+            if(next.first->get_left())
+                stack.push_back(std::make_pair(next.first->get_left(), next.second + 1));
+            if(next.first->get_right())
+                stack.push_back(std::make_pair(next.first->get_right(), next.second + 1));
+        }
+        
+        // Return the sum of the depths
+        return depths;
+    }
+    
+    template <class T>
+    inline unsigned long Binary_tree<T>::rebuilds()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Return the number of rebuilds
+        return m_rebuilds;
+    }
+    
+    template <class T>
+    template <class Function>
+    void Binary_tree<T>::for_each(Function &function)
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Define the stack of elements to visit
+        std::vector<T*> stack;
+        if(s_root)
+            stack.push_back(s_root);
+        
+        // Loop over the elements
+        while(!stack.empty())
+        {
+            // Pop the next element
+            T *next = stack.back();
+            stack.pop_back();
+            
+            // Call function on it
+            function(static_cast<const T*>(next));
+            
+            // Push its subtrees
+            if(next->get_left())
+                stack.push_back(next->get_left());
+            if(next->get_right())
+                stack.push_back(next->get_right());
+        }
+    }
+    
     template <class T>
     inline void Binary_tree<T>::clear()
     {
@@ -154,27 +309,196 @@ namespace andrews_curtis
         
         // Reset m_length
         m_length = 0;
+        
+        // Reset the depth bound
+        m_depth_bound = 0;
+        m_bound_size = 4.0 / 3.0;
+        
+        // Reset m_rebuilds
+        m_rebuilds = 0;
+    }
+    
+    template <class T>
+    inline void Binary_tree<T>::detach()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Set s_root to 0, leaving the elements to their owner
+        s_root = 0;
+        
+        // Reset m_size
+        m_size = 0;
+        
+        // Reset m_length
+        m_length = 0;
+        
+        // Reset the depth bound
+        m_depth_bound = 0;
+        m_bound_size = 4.0 / 3.0;
+        
+        // Reset m_rebuilds
+        m_rebuilds = 0;
     }
     
     template <class T>
     void Binary_tree<T>::clear(T *element)
     {
-        // If !element return to caller
-        if(!element)
-            return;
+        // Loop until the subtree of element is empty (Note: iterative, so a deep tree can not overflow the stack)
+        while(element)
+        {
+            // Obtain the root of element's left subtree
+            T *left = element->get_left();
+            
+            // If element has a left subtree, rotate it right, moving element down into it
+            if(left)
+            {
+                element->set_left(left->get_right());
+                left->set_right(element);
+                element = left;
+                continue;
+            }
+            
+            // Obtain the root of element's right subtree, all that remains of the subtree
+            T *right = element->get_right();
+            
+            // Delete element
+            delete element;
+            
+            // Clear the right subtree
+            element = right;
+        }
+    }
+    
+    template <class T>
+    unsigned long Binary_tree<T>::get_size(T *element)
+    {
+        // Define the size
+        unsigned long size = 0;
+        
+        // Define the stack of elements to count
+        std::vector<T*> stack;
+        if(element)
+            stack.push_back(element);
+        
+        // Loop over the elements, counting each
+        while(!stack.empty())
+        {
+            // Pop the next element
+            T *next = stack.back();
+            stack.pop_back();
+            
+            // Count it
+            ++size;
+            
+            // Push its subtrees
+            if(next->get_left())
+                stack.push_back(next->get_left());
+            if(next->get_right())
+                stack.push_back(next->get_right());
+        }
+        
+        // Return the size
+        return size;
+    }
+    
+    template <class T>
+    void Binary_tree<T>::rebalance(T *element, T **path, unsigned int depth)
+    {
+        // Define the child on the path and the size of its subtree
+        T *child = element;
+        unsigned long size = 1;
         
-        // Obtain the root of element's left subtree
-        T *left = element->m_left;
+        // Loop up the path, from the parent of element, looking for the scapegoat
+        for(unsigned int index = depth; index-- > 0; )
+        {
+            // Obtain the ancestor and the child off the path
+            T *ancestor = path[index];
+            T *sibling = (ancestor->get_left() == child) ? ancestor->get_right() : ancestor->get_left();
+            
+            // Obtain the size of the ancestor's subtree
+            unsigned long ancestor_size = size + get_size(sibling) + 1;
+            
+            // If the child holds more than 3/4 of the elements, ancestor is the scapegoat
+            // (Note: as element is deeper than the bound, there is such an ancestor)
+            if((4 * size) > (3 * ancestor_size))
+            {
+                // Rebuild the scapegoat's subtree
+                T *root = rebuild(ancestor, ancestor_size);
+                
+                // Link the rebuilt subtree in place of the scapegoat's
+                if(!index)
+                    s_root = root;
+                else if(path[index - 1]->get_left() == ancestor)
+                    path[index - 1]->set_left(root);
+                else
+                    path[index - 1]->set_right(root);
+                
+                // Increment m_rebuilds
+                ++m_rebuilds;
+                
+                // Return to caller
+                return;
+            }
+            
+            // Move up the path
+            child = ancestor;
+            size = ancestor_size;
+        }
+    }
+    
+    template <class T>
+    T *Binary_tree<T>::rebuild(T *element, unsigned long size)
+    {
+        // Define the elements of the subtree, in order
+        std::vector<T*> elements;
+        elements.reserve(size);
+        
+        // Define the stack of elements whose left subtree was visited
+        std::vector<T*> stack;
+        
+        // Loop over the elements in order
+        T *current_element = element;
+        while(current_element || !stack.empty())
+        {
+            // Descend to the least element of the current subtree
+            while(current_element)
+            {
+                stack.push_back(current_element);
+                current_element = current_element->get_left();
+            }
+            
+            // Visit the least element not yet visited
+            current_element = stack.back();
+            stack.pop_back();
+            elements.push_back(current_element);
+            
+            // Continue with its right subtree
+            current_element = current_element->get_right();
+        }
+        
+        // Link the elements into a perfectly balanced subtree
+        return build(&elements[0], elements.size());
+    }
+    
+    template <class T>
+    T *Binary_tree<T>::build(T **elements, unsigned long size)
+    {
+        // An empty subtree has no root
+        if(!size)
+            return 0;
         
-        // Obtain the root of element's right subtree
-        T *right = element->m_right;
+        // Obtain the middle element, the root
+        unsigned long middle = size / 2;
+        T *root = elements[middle];
         
-        // Delete element
-        delete element;
+        // Build the subtrees of the lesser and greater elements (Note: recurses
+        // log2(size) deep)
+        root->set_left(build(elements, middle));
+        root->set_right(build(elements + middle + 1, size - middle - 1));
         
-        // Clear the left and right subtrees
-        clear(left);
-        clear(right);
+        // Return the root
+        return root;
     }
 }
 
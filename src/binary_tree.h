@@ -10,16 +10,25 @@
 #define Andrews_Curtis_Conjecture_binary_tree_h
 
 
+#include <vector>
+
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_guard.hpp>
 
 namespace andrews_curtis
 {
     ///
-    /// This class encapsulates the functionality of a global binary tree.
+    /// This class encapsulates the functionality of a global binary tree. The
+    /// tree is a scapegoat tree: when an element is inserted deeper than
+    /// log_{4/3} of the size of the tree, the subtree of its lowest ancestor
+    /// whose child on the path holds more than 3/4 of its elements, the
+    /// scapegoat, is rebuilt perfectly balanced. So, the height of the tree
+    /// stays logarithmic, with no balancing data in the elements.
     ///
-    /// The passed type T must have operator==, operator<, a member m_left of
-    /// type T*, and a member m_right of typer T*.
+    /// The passed type T must have operator==, operator<, and methods
+    /// get_left() and get_right() returning T*, and set_left(T*) and
+    /// set_right(T*), linking an element to its subtrees. As rebuilding moves
+    /// elements, operator< must be a strict weak ordering.
     ///
     template <class T>
     class Binary_tree
@@ -36,6 +45,16 @@ namespace andrews_curtis
         ///
         static T *insert(T *element);
         
+        ///
+        /// Finds an element in the binary tree, without inserting it. This
+        /// method returns a pointer to the equivalent element in the binary
+        /// tree, or 0 if there is no such element.
+        ///
+        /// \param element The element to find in the Binary_tree
+        /// \return The equivalent instance in the tree or 0
+        ///
+        static T *find(const T *element);
+        
         ///
         /// Obtains the size of this binary tree
         ///
@@ -50,12 +69,50 @@ namespace andrews_curtis
         ///
         static unsigned long length();
         
+        ///
+        /// Obtains the height of this binary tree, the number of elements on
+        /// its longest path from the root. This walks the whole tree.
+        ///
+        /// \return The height of this binary tree
+        ///
+        static unsigned long height();
+        
+        ///
+        /// Obtains the sum of the depths of the elements of this binary tree,
+        /// the root having depth 1. This walks the whole tree.
+        ///
+        /// \return The sum of the depths of the elements of this binary tree
+        ///
+        static unsigned long depths();
+        
+        ///
+        /// Obtains the number of subtrees rebuilt since this binary tree was
+        /// last cleared
+        ///
+        /// \return The number of subtrees rebuilt
+        ///
+        static unsigned long rebuilds();
+        
+        ///
+        /// Calls the passed function on each element of the binary tree. No
+        /// thread may be inserting.
+        ///
+        /// \param function The function to call, on a const T*
+        ///
+        template <class Function> static void for_each(Function &function);
+        
         ///
         /// Clear the binary tree of all elements and calls the destructor
         /// of each contained element.
         ///
         static void clear();
         
+        ///
+        /// Empties the binary tree without calling the destructor of any
+        /// element, so the elements outlive the tree, their links stale.
+        ///
+        static void detach();
+        
         /// Mutex for the tree
         static boost::mutex m_mutex;
         
@@ -70,10 +127,39 @@ namespace andrews_curtis
         /// The length of the binary tree's elements
         static unsigned long m_length;
         
+        /// The most elements on the path to an inserted element, by the bound
+        /// on the depth, log_{4/3}(2^64) + 1
+        static const unsigned int s_max_depth = 160;
+        
+        /// The bound on the depth of an element, floor(log_{4/3}(m_size))
+        static unsigned long m_depth_bound;
+        
+        /// The least size for which the depth bound is one more
+        static double m_bound_size;
+        
+        /// The number of subtrees rebuilt
+        static unsigned long m_rebuilds;
+        
         
     private:
-        /// Utility function used by clear
+        /// Utility function used by clear, deleting the elements of the
+        /// subtree of element with no recursion, by right rotations
         static void clear(T *element);
+        
+        /// Utility function returning the number of elements in a subtree
+        static unsigned long get_size(T *element);
+        
+        /// Utility function rebalancing the tree after element was inserted
+        /// below the path elements of the passed depth
+        static void rebalance(T *element, T **path, unsigned int depth);
+        
+        /// Utility function rebuilding the subtree of the passed size rooted
+        /// at element perfectly balanced, returning its new root
+        static T *rebuild(T *element, unsigned long size);
+        
+        /// Utility function linking the passed in order elements into a
+        /// perfectly balanced subtree, returning its root
+        static T *build(T **elements, unsigned long size);
     };
 }
 
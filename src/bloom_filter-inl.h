@@ -0,0 +1,42 @@
+//
+//  bloom_filter-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_bloom_filter_inl_h
+#define Andrews_Curtis_Conjecture_bloom_filter_inl_h
+
+
+namespace andrews_curtis
+{
+    inline void Bloom_filter::add(boost::uint64_t high, boost::uint64_t low)
+    {
+        // Obtain the block of the fingerprint
+        boost::atomic<boost::uint64_t> *block = s_words + (high & (s_blocks - 1)) * s_block_words;
+        
+        // Set one bit in each word of the block, picked by 6 bits of low
+        for(std::size_t word = 0; word < s_block_words; ++word, low >>= 6)
+            block[word].fetch_or(static_cast<boost::uint64_t>(0x1) << (low & 0x3F), boost::memory_order_relaxed);
+    }
+    
+    inline bool Bloom_filter::contains(boost::uint64_t high, boost::uint64_t low)
+    {
+        // Obtain the block of the fingerprint
+        const boost::atomic<boost::uint64_t> *block = s_words + (high & (s_blocks - 1)) * s_block_words;
+        
+        // Check the bit in each word of the block, any clear bit means the fingerprint was not added
+        for(std::size_t word = 0; word < s_block_words; ++word, low >>= 6)
+        {
+            if(!(block[word].load(boost::memory_order_relaxed) & (static_cast<boost::uint64_t>(0x1) << (low & 0x3F))))
+                return false;
+        }
+        
+        // Return true, the fingerprint may have been added
+        return true;
+    }
+}
+
+#endif
@@ -0,0 +1,85 @@
+//
+//  bloom_filter.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <new>
+
+#include <boost/align/aligned_alloc.hpp>
+
+#include "bloom_filter.h"
+
+
+namespace andrews_curtis
+{
+    // Define Bloom_filter::s_words
+    boost::atomic<boost::uint64_t> *Bloom_filter::s_words = 0;
+    
+    // Define Bloom_filter::s_blocks
+    std::size_t Bloom_filter::s_blocks = 0;
+    
+    
+    bool Bloom_filter::reserve(unsigned long count)
+    {
+        // Obtain the number of blocks for count fingerprints, a power of 2
+        std::size_t blocks = s_min_blocks;
+        while((blocks * s_block_words * 64) < (count * s_bits_per_fingerprint))
+            blocks <<= 1;
+        
+        // If the filter is large enough, keep it
+        if(blocks <= s_blocks)
+            return false;
+        
+        // Free the filter
+        clear();
+        
+        // Obtain the new words, aligned to a cache line
+        void *words = boost::alignment::aligned_alloc(s_block_words * sizeof(boost::uint64_t), blocks * s_block_words * sizeof(boost::atomic<boost::uint64_t>));
+        
+        // If out of memory, throw as ::operator new would
+        if(!words)
+            throw std::bad_alloc();
+        
+        // Construct the words, empty
+        s_words = static_cast<boost::atomic<boost::uint64_t>*>(words);
+        for(std::size_t word = 0; word < blocks * s_block_words; ++word)
+            new (s_words + word) boost::atomic<boost::uint64_t>(0);
+        
+        // Set s_blocks
+        s_blocks = blocks;
+        
+        // Return true, the filter was emptied
+        return true;
+    }
+    
+    unsigned long Bloom_filter::get_set_bits()
+    {
+        // Define the number of bits set
+        unsigned long set_bits = 0;
+        
+        // Sum the bits set of the words
+        for(std::size_t word = 0; word < s_blocks * s_block_words; ++word)
+            set_bits += __builtin_popcountll(s_words[word].load(boost::memory_order_relaxed));
+        
+        // Return the number of bits set
+        return set_bits;
+    }
+    
+    unsigned long Bloom_filter::get_bits()
+    {
+        return s_blocks * s_block_words * 64;
+    }
+    
+    void Bloom_filter::clear()
+    {
+        // Free the words (Note: boost::atomic<boost::uint64_t> has a trivial destructor)
+        boost::alignment::aligned_free(s_words);
+        
+        // Reset the filter
+        s_words = 0;
+        s_blocks = 0;
+    }
+}
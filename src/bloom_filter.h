@@ -0,0 +1,108 @@
+//
+//  bloom_filter.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_bloom_filter_h
+#define Andrews_Curtis_Conjecture_bloom_filter_h
+
+
+#include <cstddef>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+
+
+namespace andrews_curtis
+{
+    ///
+    /// This class encapsulates the functionality of a global, concurrent,
+    /// blocked Bloom filter of 128 bit fingerprints. If contains() returns
+    /// false the fingerprint was definitely never added; if it returns true
+    /// the fingerprint was added or, with small probability, was not.
+    ///
+    /// The filter is sized by reserve(), which, if the filter must grow,
+    /// empties it; the caller then re-adds the fingerprints of all the
+    /// elements that are to be in it. Only add() and contains() may be called
+    /// by several threads at once.
+    ///
+    class Bloom_filter
+    {
+    public:
+        ///
+        /// Adds a fingerprint to the filter
+        ///
+        /// \param high The high 64 bits of the fingerprint
+        /// \param low The low 64 bits of the fingerprint
+        ///
+        static void add(boost::uint64_t high, boost::uint64_t low);
+        
+        ///
+        /// Returns a bool indicating if a fingerprint may have been added to
+        /// the filter. If false, the fingerprint was definitely not added.
+        ///
+        /// \param high The high 64 bits of the fingerprint
+        /// \param low The low 64 bits of the fingerprint
+        /// \return A bool indicating if the fingerprint may have been added
+        ///
+        static bool contains(boost::uint64_t high, boost::uint64_t low);
+        
+        ///
+        /// Sizes the filter for the passed number of fingerprints. If the
+        /// filter is too small it is replaced by a larger, empty, filter.
+        ///
+        /// \param count The number of fingerprints the filter is to hold
+        /// \return A bool indicating if the filter was emptied
+        ///
+        static bool reserve(unsigned long count);
+        
+        ///
+        /// Obtains the number of bits of the filter that are set
+        ///
+        /// \return The number of bits set
+        ///
+        static unsigned long get_set_bits();
+        
+        ///
+        /// Obtains the number of bits of the filter
+        ///
+        /// \return The number of bits
+        ///
+        static unsigned long get_bits();
+        
+        ///
+        /// Frees the filter
+        ///
+        static void clear();
+    
+    
+    private:
+        /// The number of 64 bit words of a block, a cache line
+        static const std::size_t s_block_words = 8;
+        
+        /// The number of bits of the filter per fingerprint it is sized for
+        static const unsigned long s_bits_per_fingerprint = 16;
+        
+        /// The least number of blocks of the filter
+        static const std::size_t s_min_blocks = 0x1 << 10;
+        
+        /// Note: A fingerprint sets one bit in each word of one block, picked
+        /// by the high and low bits of the fingerprint respectively. So, add()
+        /// and contains() touch a single cache line, whatever the number of
+        /// bits a fingerprint sets. With 16 bits per fingerprint, the false
+        /// positive rate of a full filter is about a twentieth of a percent.
+        
+        /// The words of the filter, aligned to a cache line
+        static boost::atomic<boost::uint64_t> *s_words;
+        
+        /// The number of blocks of the filter, a power of 2
+        static std::size_t s_blocks;
+    };
+}
+
+#include "bloom_filter-inl.h"
+
+#endif
@@ -0,0 +1,379 @@
+//
+//  external_store.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <cstdio>
+#include <queue>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/mpi/communicator.hpp>
+
+#include "globals.h"
+#include "relator.h"
+#include "relator_table.h"
+#include "external_store.h"
+#include "balanced_presentation.h"
+
+
+namespace andrews_curtis
+{
+    // Define External_store::s_prefix
+    std::string External_store::s_prefix;
+    
+    // Define External_store::s_records
+    std::vector<unsigned int> External_store::s_records;
+    
+    // Define External_store::s_runs
+    unsigned int External_store::s_runs = 0;
+    
+    // Define External_store::s_mutex
+    boost::mutex External_store::s_mutex;
+    
+    // Define External_store::s_size
+    unsigned long External_store::s_size = 0;
+    
+    // Define External_store::s_bytes
+    unsigned long External_store::s_bytes = 0;
+    
+    // The number of bytes buffered when reading or writing a file
+    static const std::size_t s_file_buffer_size = 0x1 << 20;
+    
+    // A reader of a sorted file of records, holding the record it is at
+    struct Record_reader
+    {
+        /// The file read
+        std::FILE *m_file;
+        
+        /// The buffer of the file
+        std::vector<char> m_buffer;
+        
+        /// The relators of the record the reader is at
+        std::vector<Relator> m_record;
+        
+        /// A bool indicating if the reader is at a record, i.e. not at the end
+        bool m_is_valid;
+        
+        /// A bool indicating if the file is that of the presentations found before
+        bool m_is_visited;
+    };
+    
+    // A comparison of the Record_readers with the passed indices, by their records, putting the least record at the top of a heap
+    struct Record_reader_greater
+    {
+        /// The readers compared
+        const std::vector<Record_reader> *m_readers;
+        
+        /// Returns a bool indicating if the record of the reader lhs is greater than that of the reader rhs
+        bool operator()(std::size_t lhs, std::size_t rhs) const;
+    };
+    
+    // Utility function to open a file, throwing if it can not be opened
+    std::FILE *open_file(const std::string &path, const char *mode, std::vector<char> &buffer);
+    
+    // Utility function to advance a Record_reader to its next record
+    void advance(Record_reader &reader);
+    
+    // Utility function to compare the relators of records lexicographically
+    bool is_lesser_record(const std::vector<Relator> &lhs, const std::vector<Relator> &rhs);
+    
+    // Utility function to compare the words identified by the ids of records lexicographically
+    bool is_lesser_id_record(const unsigned int *lhs, const unsigned int *rhs);
+    
+    
+    void External_store::open(const std::string &directory)
+    {
+        // Define the world communicator in which we reside
+        boost::mpi::communicator communicator;
+        
+        // Name the files after the process
+        std::ostringstream prefix;
+        prefix << directory << "/ac." << communicator.rank() << ".";
+        s_prefix = prefix.str();
+        
+        // Remove any file of presentations found left by an earlier search
+        std::remove(get_visited_path().c_str());
+        
+        // Reserve the records of a run
+        s_records.reserve(s_run_records * g_relators_count);
+    }
+    
+    void External_store::add(const Balanced_presentation *balanced_presentation)
+    {
+        // Define the records of a full run, and its number
+        std::vector<unsigned int> records;
+        unsigned int run = 0;
+        
+        // Define scope for the lock
+        {
+            // Lock s_mutex
+            boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+            
+            // Append the ids of balanced_presentation to the run
+            for(unsigned int index = 0; index < g_relators_count; ++index)
+                s_records.push_back(balanced_presentation->get_relator_id(index));
+            
+            // If the run is not full, there is nothing more to do
+            if(s_records.size() < (s_run_records * g_relators_count))
+                return;
+            
+            // Take the full run and number it, so other threads may fill the next
+            records.swap(s_records);
+            s_records.reserve(s_run_records * g_relators_count);
+            run = s_runs++;
+        }
+        
+        // Write the run, outside the lock
+        write_run(records, run);
+    }
+    
+    void External_store::flush()
+    {
+        // Write the last run of the level, if any
+        if(!s_records.empty())
+        {
+            write_run(s_records, s_runs++);
+            s_records.reserve(s_run_records * g_relators_count);
+        }
+    }
+    
+    void External_store::merge(const boost::function<void (const std::vector<Relator>&)> &function)
+    {
+        // Write the last run of the level, if not yet written
+        flush();
+        
+        // Define the readers, of the runs and the file of presentations found before
+        std::vector<Record_reader> readers(s_runs + 1);
+        
+        // Open the readers of the runs
+        for(unsigned int run = 0; run < s_runs; ++run)
+        {
+            readers[run].m_file = open_file(get_run_path(run), "rb", readers[run].m_buffer);
+            readers[run].m_is_visited = false;
+            advance(readers[run]);
+        }
+        
+        // Open the reader of the presentations found before, which there are none of at first
+        Record_reader &visited = readers[s_runs];
+        visited.m_file = s_size ? open_file(get_visited_path(), "rb", visited.m_buffer) : 0;
+        visited.m_is_visited = true;
+        visited.m_is_valid = false;
+        if(visited.m_file)
+            advance(visited);
+        
+        // Define a heap of the readers not at their end, the reader at the least record on top
+        Record_reader_greater greater;
+        greater.m_readers = &readers;
+        std::priority_queue<std::size_t, std::vector<std::size_t>, Record_reader_greater> heap(greater);
+        for(std::size_t reader = 0; reader < readers.size(); ++reader)
+        {
+            if(readers[reader].m_is_valid)
+                heap.push(reader);
+        }
+        
+        // Open the new file of presentations found
+        std::vector<char> buffer;
+        std::FILE *merged = open_file(get_visited_path() + ".merging", "wb", buffer);
+        
+        // Define the least record and the number of records merged
+        std::vector<Relator> least(g_relators_count);
+        unsigned long size = 0;
+        
+        // Loop over the records, least first, until the readers are all at their end
+        while(!heap.empty())
+        {
+            // Take the least record from the reader on top, noting if it was found before, and advance the reader past it
+            std::size_t reader = heap.top();
+            heap.pop();
+            least.swap(readers[reader].m_record);
+            bool is_visited = readers[reader].m_is_visited;
+            advance(readers[reader]);
+            if(readers[reader].m_is_valid)
+                heap.push(reader);
+            
+            // Advance the other readers at the least record, which are on top in turn, noting if it was found before
+            while(!heap.empty() && !is_lesser_record(least, readers[heap.top()].m_record))
+            {
+                reader = heap.top();
+                heap.pop();
+                is_visited = is_visited || readers[reader].m_is_visited;
+                advance(readers[reader]);
+                if(readers[reader].m_is_valid)
+                    heap.push(reader);
+            }
+            
+            // Write the least record, once
+            for(std::vector<Relator>::const_iterator itr = least.begin(); itr != least.end(); ++itr)
+            {
+                if(!itr->write(merged))
+                    throw std::runtime_error("Could not write " + get_visited_path() + ".merging");
+            }
+            ++size;
+            
+            // If the record was not found before, it is in the next level
+            if(!is_visited)
+                function(least);
+        }
+        
+        // Obtain the bytes of the new file
+        long bytes = std::ftell(merged);
+        
+        // Close the readers and the new file
+        for(std::vector<Record_reader>::iterator itr = readers.begin(); itr != readers.end(); ++itr)
+        {
+            if(itr->m_file)
+                std::fclose(itr->m_file);
+        }
+        if(std::fclose(merged) || (bytes < 0))
+            throw std::runtime_error("Could not write " + get_visited_path() + ".merging");
+        
+        // Remove the runs
+        for(unsigned int run = 0; run < s_runs; ++run)
+            std::remove(get_run_path(run).c_str());
+        s_runs = 0;
+        
+        // Replace the file of presentations found with the new one
+        if(std::rename((get_visited_path() + ".merging").c_str(), get_visited_path().c_str()))
+            throw std::runtime_error("Could not rename " + get_visited_path() + ".merging");
+        
+        // Set s_size and s_bytes
+        s_size = size;
+        s_bytes = static_cast<unsigned long>(bytes);
+    }
+    
+    unsigned long External_store::size()
+    {
+        return s_size;
+    }
+    
+    unsigned long External_store::get_bytes()
+    {
+        return s_bytes;
+    }
+    
+    void External_store::clear()
+    {
+        // If the store was never opened, there is nothing to remove
+        if(s_prefix.empty())
+            return;
+        
+        // Remove the runs and the file of presentations found
+        for(unsigned int run = 0; run < s_runs; ++run)
+            std::remove(get_run_path(run).c_str());
+        std::remove(get_visited_path().c_str());
+        
+        // Reset the store
+        std::vector<unsigned int>().swap(s_records);
+        s_runs = 0;
+        s_size = 0;
+        s_bytes = 0;
+    }
+    
+    void External_store::write_run(std::vector<unsigned int> &records, unsigned int run)
+    {
+        // Define pointers to the records, to sort
+        std::vector<const unsigned int*> sorted;
+        sorted.reserve(records.size() / g_relators_count);
+        for(std::size_t record = 0; record < records.size(); record += g_relators_count)
+            sorted.push_back(&records[record]);
+        
+        // Sort the records, by the words their ids identify
+        std::sort(sorted.begin(), sorted.end(), is_lesser_id_record);
+        
+        // Open the run
+        std::vector<char> buffer;
+        std::FILE *file = open_file(get_run_path(run), "wb", buffer);
+        
+        // Write the words of the records, each distinct record once
+        for(std::size_t record = 0; record < sorted.size(); ++record)
+        {
+            // Skip a record equal to the previous one (Note: equal words have equal ids)
+            if(record && std::equal(sorted[record - 1], sorted[record - 1] + g_relators_count, sorted[record]))
+                continue;
+            
+            // Write the relators of the record
+            for(unsigned int index = 0; index < g_relators_count; ++index)
+            {
+                if(!Relator_table::get_relator(sorted[record][index])->write(file))
+                    throw std::runtime_error("Could not write " + get_run_path(run));
+            }
+        }
+        
+        // Close the run
+        if(std::fclose(file))
+            throw std::runtime_error("Could not write " + get_run_path(run));
+        
+        // Free the records
+        std::vector<unsigned int>().swap(records);
+    }
+    
+    std::string External_store::get_run_path(unsigned int run)
+    {
+        // Define the path
+        std::ostringstream path;
+        path << s_prefix << "run." << run;
+        
+        // Return the path
+        return path.str();
+    }
+    
+    std::string External_store::get_visited_path()
+    {
+        return s_prefix + "visited";
+    }
+    
+    std::FILE *open_file(const std::string &path, const char *mode, std::vector<char> &buffer)
+    {
+        // Open the file
+        std::FILE *file = std::fopen(path.c_str(), mode);
+        
+        // If it can not be opened, throw
+        if(!file)
+            throw std::runtime_error("Could not open " + path);
+        
+        // Buffer it, reading and writing large blocks
+        buffer.resize(s_file_buffer_size);
+        std::setvbuf(file, &buffer[0], _IOFBF, buffer.size());
+        
+        // Return the file
+        return file;
+    }
+    
+    bool Record_reader_greater::operator()(std::size_t lhs, std::size_t rhs) const
+    {
+        return is_lesser_record((*m_readers)[rhs].m_record, (*m_readers)[lhs].m_record);
+    }
+    
+    void advance(Record_reader &reader)
+    {
+        // Read the relators of the next record, if there is one
+        reader.m_record.resize(g_relators_count);
+        reader.m_is_valid = true;
+        for(std::vector<Relator>::iterator itr = reader.m_record.begin(); reader.m_is_valid && (itr != reader.m_record.end()); ++itr)
+            reader.m_is_valid = itr->read(reader.m_file);
+    }
+    
+    bool is_lesser_record(const std::vector<Relator> &lhs, const std::vector<Relator> &rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    
+    bool is_lesser_id_record(const unsigned int *lhs, const unsigned int *rhs)
+    {
+        // Compare the relators in turn, the first unequal pair deciding (Note: unequal ids identify unequal words)
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+        {
+            if(lhs[index] != rhs[index])
+                return *Relator_table::get_relator(lhs[index]) < *Relator_table::get_relator(rhs[index]);
+        }
+        
+        // Return false, the records are equal
+        return false;
+    }
+}
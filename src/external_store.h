@@ -0,0 +1,154 @@
+//
+//  external_store.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_external_store_h
+#define Andrews_Curtis_Conjecture_external_store_h
+
+
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+
+namespace andrews_curtis
+{
+    // Forward declarations
+    class Relator;
+    class Balanced_presentation;
+    
+    ///
+    /// This class encapsulates the functionality of a global, on disk, set of
+    /// the presentations found, for external memory search. On disk, a
+    /// presentation is held as the words of its relators, a record, so the
+    /// records do not refer to the Relator_table.
+    ///
+    /// The presentations found in a level are add()ed to the store, which
+    /// writes them out in sorted runs. Once the level is complete, merge()
+    /// merges the runs into the sorted file of all presentations found before,
+    /// passing on those that were not found before, the next level. So,
+    /// duplicates are only detected once a level is complete.
+    ///
+    /// Once flush() has written out the level, no record refers to the
+    /// Relator_table, so it may be cleared; only the relators of the next
+    /// level, interned as merge() passes them on, are then held in memory.
+    ///
+    class External_store
+    {
+    public:
+        ///
+        /// Opens the store, in the passed directory. Its files are named
+        /// after the process, so processes may share a directory.
+        ///
+        /// \param directory The directory in which to keep the store's files
+        ///
+        static void open(const std::string &directory);
+        
+        ///
+        /// Adds a presentation found in the current level to the store. Many
+        /// threads may add at once.
+        ///
+        /// \param balanced_presentation The presentation to add
+        ///
+        static void add(const Balanced_presentation *balanced_presentation);
+        
+        ///
+        /// Writes out the presentations added in the current level that are
+        /// not yet written. No thread may be adding.
+        ///
+        static void flush();
+        
+        ///
+        /// Completes the current level, merging the presentations added into
+        /// the store and calling the passed function on each one not found
+        /// before, in order. No thread may be adding.
+        ///
+        /// \param function The function to call, on the relators of a new
+        ///                 presentation
+        ///
+        static void merge(const boost::function<void (const std::vector<Relator>&)> &function);
+        
+        ///
+        /// Obtains the number of presentations in the store, as of the last
+        /// merge()
+        ///
+        /// \return The number of presentations in the store
+        ///
+        static unsigned long size();
+        
+        ///
+        /// Obtains the number of bytes on disk of the presentations in the
+        /// store, as of the last merge()
+        ///
+        /// \return The number of bytes on disk
+        ///
+        static unsigned long get_bytes();
+        
+        ///
+        /// Removes the store's files
+        ///
+        static void clear();
+    
+    
+    private:
+        /// The number of records in a run
+        static const std::size_t s_run_records = 0x1 << 22;
+        
+        /// Note: The records of a run are held in memory as ids, sorted by the
+        /// words they identify, deduplicated and written out as words, so at
+        /// most a run's records, s_run_records * g_relators_count ids, are held
+        /// in memory whatever the number of children of a level.
+        
+        /// The prefix of the paths of the store's files
+        static std::string s_prefix;
+        
+        /// The records of the run being filled
+        static std::vector<unsigned int> s_records;
+        
+        /// The number of runs written in the current level
+        static unsigned int s_runs;
+        
+        /// Mutex for s_records and s_runs
+        static boost::mutex s_mutex;
+        
+        /// The number of presentations in the store
+        static unsigned long s_size;
+        
+        /// The number of bytes of the file of all presentations found
+        static unsigned long s_bytes;
+    
+    
+    private:
+        //
+        // Sorts and deduplicates the passed records, writing their words to the
+        // run with the passed number
+        //
+        // \param records The ids of the records of the run
+        // \param run The number of the run
+        //
+        static void write_run(std::vector<unsigned int> &records, unsigned int run);
+        
+        //
+        // Returns the path of the run with the passed number
+        //
+        // \param run The number of the run
+        // \return The path of the run
+        //
+        static std::string get_run_path(unsigned int run);
+        
+        //
+        // Returns the path of the file of all presentations found
+        //
+        // \return The path of the file of all presentations found
+        //
+        static std::string get_visited_path();
+    };
+}
+
+#endif
@@ -0,0 +1,246 @@
+//
+//  fingerprint_set-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_fingerprint_set_inl_h
+#define Andrews_Curtis_Conjecture_fingerprint_set_inl_h
+
+
+#include <cmath>
+
+#include <boost/thread/lock_guard.hpp>
+
+
+namespace andrews_curtis
+{
+    // Define Fingerprint_set<T>::s_shards
+    template <class T>
+    typename Fingerprint_set<T>::Shard Fingerprint_set<T>::s_shards[0x1 << Fingerprint_set<T>::s_shard_bits];
+    
+    // Define Fingerprint_set<T>::s_size
+    template <class T>
+    boost::atomic<unsigned long> Fingerprint_set<T>::s_size(0);
+    
+    // Define Fingerprint_set<T>::s_capacity
+    template <class T>
+    boost::atomic<unsigned long> Fingerprint_set<T>::s_capacity(0);
+    
+    
+    template <class T>
+    inline bool Fingerprint_set<T>::insert(const T *element)
+    {
+        // Obtain the fingerprint of element
+        Fingerprint fingerprint;
+        get_fingerprint(element, fingerprint);
+        
+        // Obtain the shard of element
+        Shard &shard = get_shard(fingerprint);
+        
+        // Lock the shard's mutex
+        boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+        
+        // Create the first slots of the shard, if need be
+        if(!shard.m_capacity)
+            grow(shard);
+        
+        // Obtain the slot of the fingerprint
+        Fingerprint *slot = get_slot(shard, fingerprint);
+        
+        // If the slot holds the fingerprint, it was already present
+        if(slot->m_high || slot->m_low)
+            return true;
+        
+        // Claim the empty slot
+        *slot = fingerprint;
+        
+        // Increment s_size
+        s_size.fetch_add(1, boost::memory_order_relaxed);
+        
+        // Grow the shard if more than three quarters of its slots are occupied
+        if((4 * (++shard.m_size)) > (3 * shard.m_capacity))
+            grow(shard);
+        
+        // Return false indicating the fingerprint was inserted
+        return false;
+    }
+    
+    template <class T>
+    inline bool Fingerprint_set<T>::find(const T *element)
+    {
+        // Obtain the fingerprint of element
+        Fingerprint fingerprint;
+        get_fingerprint(element, fingerprint);
+        
+        // Return a bool indicating if the fingerprint is present
+        return find(fingerprint);
+    }
+    
+    template <class T>
+    inline bool Fingerprint_set<T>::find(boost::uint64_t high, boost::uint64_t low)
+    {
+        // Define the fingerprint, storing 0, which marks an empty slot, as 1
+        Fingerprint fingerprint = { high, (high || low) ? low : 1 };
+        
+        // Return a bool indicating if the fingerprint is present
+        return find(fingerprint);
+    }
+    
+    template <class T>
+    inline unsigned long Fingerprint_set<T>::size()
+    {
+        return s_size.load();
+    }
+    
+    template <class T>
+    inline unsigned long Fingerprint_set<T>::get_bytes()
+    {
+        return s_capacity.load() * sizeof(Fingerprint);
+    }
+    
+    template <class T>
+    inline double Fingerprint_set<T>::get_collision_probability(unsigned long size)
+    {
+        // Bound the probability by the expected number of colliding pairs, size choose 2 over 2^128
+        return 0.5 * static_cast<double>(size) * (static_cast<double>(size) - 1.0) * std::ldexp(1.0, -128);
+    }
+    
+    template <class T>
+    template <class Function>
+    void Fingerprint_set<T>::for_each(Function &function)
+    {
+        // Loop over shards
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Obtain the shard
+            Shard &shard = s_shards[index];
+            
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+            
+            // Loop over the slots, calling function on the fingerprint in each, if any
+            for(std::size_t slot = 0; slot < shard.m_capacity; ++slot)
+            {
+                if(shard.m_slots[slot].m_high || shard.m_slots[slot].m_low)
+                    function(shard.m_slots[slot].m_high, shard.m_slots[slot].m_low);
+            }
+        }
+    }
+    
+    template <class T>
+    void Fingerprint_set<T>::clear()
+    {
+        // Loop over shards, emptying each
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Obtain the shard
+            Shard &shard = s_shards[index];
+            
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+            
+            // Delete the slots
+            delete[] shard.m_slots;
+            
+            // Reset the shard
+            shard.m_slots = 0;
+            shard.m_capacity = 0;
+            shard.m_size = 0;
+        }
+        
+        // Reset s_size and s_capacity
+        s_size.store(0);
+        s_capacity.store(0);
+    }
+    
+    template <class T>
+    inline void Fingerprint_set<T>::get_fingerprint(const T *element, Fingerprint &fingerprint)
+    {
+        // Obtain the fingerprint of element
+        element->get_fingerprint(fingerprint.m_high, fingerprint.m_low);
+        
+        // Store the fingerprint 0, which marks an empty slot, as 1
+        if(!(fingerprint.m_high || fingerprint.m_low))
+            fingerprint.m_low = 1;
+    }
+    
+    template <class T>
+    inline bool Fingerprint_set<T>::find(const Fingerprint &fingerprint)
+    {
+        // Obtain the shard of the fingerprint
+        Shard &shard = get_shard(fingerprint);
+        
+        // Lock the shard's mutex
+        boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+        
+        // If the shard has no slots, the fingerprint is not present
+        if(!shard.m_capacity)
+            return false;
+        
+        // Obtain the slot of the fingerprint
+        Fingerprint *slot = get_slot(shard, fingerprint);
+        
+        // Return a bool indicating if the slot holds the fingerprint
+        return slot->m_high || slot->m_low;
+    }
+    
+    template <class T>
+    inline typename Fingerprint_set<T>::Shard &Fingerprint_set<T>::get_shard(const Fingerprint &fingerprint)
+    {
+        // The low bits pick the shard, the high bits the slot
+        return s_shards[fingerprint.m_low & ((0x1 << s_shard_bits) - 1)];
+    }
+    
+    template <class T>
+    inline typename Fingerprint_set<T>::Fingerprint *Fingerprint_set<T>::get_slot(Shard &shard, const Fingerprint &fingerprint)
+    {
+        // Obtain the mask of a slot
+        std::size_t mask = shard.m_capacity - 1;
+        
+        // Loop over slots, starting from the one picked by the fingerprint (Note: a shard is never full)
+        for(std::size_t slot = static_cast<std::size_t>(fingerprint.m_high) & mask; true; slot = (slot + 1) & mask)
+        {
+            // Obtain the slot
+            Fingerprint *current = shard.m_slots + slot;
+            
+            // If the slot is empty or holds the fingerprint, return it
+            if(!(current->m_high || current->m_low) || ((current->m_high == fingerprint.m_high) && (current->m_low == fingerprint.m_low)))
+                return current;
+        }
+    }
+    
+    template <class T>
+    void Fingerprint_set<T>::grow(Shard &shard)
+    {
+        // Obtain the current slots
+        Fingerprint *slots = shard.m_slots;
+        std::size_t capacity = shard.m_capacity;
+        
+        // New up twice the slots, or the first slots, empty
+        shard.m_capacity = capacity ? 2 * capacity : s_first_capacity;
+        shard.m_slots = new Fingerprint[shard.m_capacity];
+        for(std::size_t slot = 0; slot < shard.m_capacity; ++slot)
+        {
+            shard.m_slots[slot].m_high = 0;
+            shard.m_slots[slot].m_low = 0;
+        }
+        
+        // Count the new slots
+        s_capacity.fetch_add(shard.m_capacity - capacity, boost::memory_order_relaxed);
+        
+        // Loop over the occupied slots, copying each to the new slots
+        for(std::size_t slot = 0; slot < capacity; ++slot)
+        {
+            if(slots[slot].m_high || slots[slot].m_low)
+                *get_slot(shard, slots[slot]) = slots[slot];
+        }
+        
+        // Delete the old slots
+        delete[] slots;
+    }
+}
+
+#endif
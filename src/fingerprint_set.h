@@ -0,0 +1,188 @@
+//
+//  fingerprint_set.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_fingerprint_set_h
+#define Andrews_Curtis_Conjecture_fingerprint_set_h
+
+
+#include <cstddef>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+
+
+namespace andrews_curtis
+{
+    ///
+    /// This class encapsulates the functionality of a global, concurrent set
+    /// of the 128 bit fingerprints of elements. Unlike Hash_set and Binary_tree
+    /// it does not hold the elements, only their fingerprints; so, an element
+    /// may be deleted once it is inserted, and two elements are taken to be
+    /// equal if their fingerprints are. As the fingerprints of presentations
+    /// are of the words of their relators, not of Relator_table ids, nothing
+    /// in the fingerprint set refers to the Relator_table.
+    ///
+    /// The passed type T must have a method get_fingerprint(boost::uint64_t&,
+    /// boost::uint64_t&) obtaining the high and low 64 bits of the fingerprint
+    /// of an element.
+    ///
+    template <class T>
+    class Fingerprint_set
+    {
+    public:
+        ///
+        /// Inserts the fingerprint of an element into the fingerprint set.
+        /// This method returns a bool indicating if the fingerprint was
+        /// already in the fingerprint set.
+        ///
+        /// \param element The element whose fingerprint to insert
+        /// \return A bool indicating if the fingerprint was already present
+        ///
+        static bool insert(const T *element);
+        
+        ///
+        /// Finds the fingerprint of an element in the fingerprint set, without
+        /// inserting it
+        ///
+        /// \param element The element whose fingerprint to find
+        /// \return A bool indicating if the fingerprint is present
+        ///
+        static bool find(const T *element);
+        
+        ///
+        /// Finds the passed fingerprint in the fingerprint set, so an element
+        /// need not be made to be found, see
+        /// Balanced_presentation::get_child_fingerprint()
+        ///
+        /// \param high The high 64 bits of the fingerprint
+        /// \param low The low 64 bits of the fingerprint
+        /// \return A bool indicating if the fingerprint is present
+        ///
+        static bool find(boost::uint64_t high, boost::uint64_t low);
+        
+        ///
+        /// Obtains the size of this fingerprint set
+        ///
+        /// \return The size of this fingerprint set
+        ///
+        static unsigned long size();
+        
+        ///
+        /// Obtains the number of bytes of the slots of this fingerprint set
+        ///
+        /// \return The number of bytes of the slots
+        ///
+        static unsigned long get_bytes();
+        
+        ///
+        /// Obtains a bound on the probability that, of the passed number of
+        /// distinct elements, some two have the same fingerprint, so that one
+        /// of them is wrongly taken to be in the fingerprint set
+        ///
+        /// \param size The number of distinct elements
+        /// \return A bound on the probability of a collision
+        ///
+        static double get_collision_probability(unsigned long size);
+        
+        ///
+        /// Calls the passed function on each fingerprint of the fingerprint
+        /// set. No thread may be inserting.
+        ///
+        /// \param function The function to call, on the high and low 64 bits
+        ///                 of a fingerprint
+        ///
+        template <class Function> static void for_each(Function &function);
+        
+        ///
+        /// Clear the fingerprint set of all fingerprints. No thread may be
+        /// inserting or finding.
+        ///
+        static void clear();
+    
+    
+    private:
+        /// The number of bits of a fingerprint picking the shard of an element
+        static const unsigned int s_shard_bits = 8;
+        
+        /// The number of slots of the first table of a shard
+        static const std::size_t s_first_capacity = 0x1 << 8;
+        
+        ///
+        /// A fingerprint, all of whose bits are kept. The fingerprint 0 marks
+        /// an empty slot, so it is stored as 1.
+        ///
+        struct Fingerprint
+        {
+            /// The high 64 bits of the fingerprint
+            boost::uint64_t m_high;
+            
+            /// The low 64 bits of the fingerprint
+            boost::uint64_t m_low;
+        };
+        
+        ///
+        /// A shard of the fingerprint set, an open addressing hash table, with
+        /// linear probing, of the fingerprints picking the shard
+        ///
+        struct Shard
+        {
+            /// The number of slots, a power of 2, 0 until the first insert
+            std::size_t m_capacity;
+            
+            /// The number of fingerprints in the shard
+            std::size_t m_size;
+            
+            /// The slots
+            Fingerprint *m_slots;
+            
+            /// Mutex for the shard
+            boost::mutex m_mutex;
+        };
+        
+        /// Note: A slot is 16 bytes, the fingerprint alone, and a shard is grown
+        /// once more than three quarters of its slots are occupied. So, an
+        /// element takes from 21 to 43 bytes of the fingerprint set, rather
+        /// than its Balanced_presentation record and the Relators it refers
+        /// to. As a fingerprint does not fit a compare-and-swap, each shard
+        /// takes a lock; the shards are many, so threads rarely wait on one
+        /// another.
+        
+        /// The shards
+        static Shard s_shards[0x1 << s_shard_bits];
+        
+        /// The size of the fingerprint set
+        static boost::atomic<unsigned long> s_size;
+        
+        /// The number of slots of all shards
+        static boost::atomic<unsigned long> s_capacity;
+    
+    
+    private:
+        /// Utility function obtaining the fingerprint of an element
+        static void get_fingerprint(const T *element, Fingerprint &fingerprint);
+        
+        /// Utility function returning a bool indicating if a fingerprint, not
+        /// 0, is present
+        static bool find(const Fingerprint &fingerprint);
+        
+        /// Utility function returning the shard of a fingerprint
+        static Shard &get_shard(const Fingerprint &fingerprint);
+        
+        /// Utility function returning the slot of a shard holding a fingerprint,
+        /// or the empty slot at which the fingerprint would be inserted
+        static Fingerprint *get_slot(Shard &shard, const Fingerprint &fingerprint);
+        
+        /// Utility function replacing the slots of a shard with twice the slots
+        static void grow(Shard &shard);
+    };
+}
+
+#include "fingerprint_set-inl.h"
+
+#endif
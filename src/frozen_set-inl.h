@@ -0,0 +1,30 @@
+//
+//  frozen_set-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_frozen_set_inl_h
+#define Andrews_Curtis_Conjecture_frozen_set_inl_h
+
+
+#include "globals.h"
+
+
+namespace andrews_curtis
+{
+    template <class Function>
+    void Frozen_set::for_each(Function &function)
+    {
+        // Loop over the levels, and their records in Eytzinger order, calling function on each
+        for(std::size_t level = 0; level < s_levels.size(); ++level)
+        {
+            for(std::size_t record = 1; record < s_parents[level].size(); ++record)
+                function(&s_levels[level][record * g_relators_count]);
+        }
+    }
+}
+
+#endif
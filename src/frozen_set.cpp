@@ -0,0 +1,189 @@
+//
+//  frozen_set.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <algorithm>
+
+#include "globals.h"
+#include "frozen_set.h"
+#include "balanced_presentation.h"
+
+
+namespace andrews_curtis
+{
+    // Define Frozen_set::s_levels
+    std::vector< std::vector<unsigned int> > Frozen_set::s_levels;
+    
+    // Define Frozen_set::s_parents
+    std::vector< std::vector<boost::uint64_t> > Frozen_set::s_parents;
+    
+    // Define Frozen_set::s_offsets
+    std::vector<std::size_t> Frozen_set::s_offsets;
+    
+    // Define Frozen_set::s_size
+    std::size_t Frozen_set::s_size = 0;
+    
+    // Utility function to compare records lexicographically
+    bool is_lesser_frozen_record(const unsigned int *lhs, const unsigned int *rhs);
+    
+    // Utility function to compare a record with the ids of a presentation lexicographically, as -1, 0 or 1
+    int compare_frozen_record(const unsigned int *record, const Balanced_presentation *balanced_presentation);
+    
+    // A comparison of the indices of records by their records, so the records of a level are sorted without moving them
+    struct Frozen_record_lesser
+    {
+        /// The ids of the relators of the records
+        const unsigned int *m_records;
+        
+        /// Returns a bool indicating if the record with index lhs is less than that with index rhs
+        bool operator()(boost::uint32_t lhs, boost::uint32_t rhs) const;
+    };
+    
+    
+    bool Frozen_set::contains(const Balanced_presentation *balanced_presentation)
+    {
+        return 0 != find(balanced_presentation);
+    }
+    
+    boost::uint32_t Frozen_set::find(const Balanced_presentation *balanced_presentation)
+    {
+        // Loop over the levels, newest first
+        for(std::size_t level = s_levels.size(); level-- > 0;)
+        {
+            // Obtain the records of the level and their number
+            const unsigned int *records = &s_levels[level][0];
+            std::size_t size = s_parents[level].size() - 1;
+            
+            // Descend, to the left of records not lesser than balanced_presentation, to the right of lesser ones
+            std::size_t record = 1;
+            while(record <= size)
+            {
+                // Prefetch the records 4 levels on, which are adjacent
+                if((record << 4) <= size)
+                    __builtin_prefetch(records + (record << 4) * g_relators_count);
+                
+                record = (record << 1) + (compare_frozen_record(records + record * g_relators_count, balanced_presentation) < 0);
+            }
+            
+            // Undo the trailing right turns and one left turn, reaching the least record not lesser than balanced_presentation, if any
+            record >>= __builtin_ffsll(~static_cast<unsigned long long>(record));
+            
+            // If that record is that of balanced_presentation, return its frozen index
+            if(record && !compare_frozen_record(records + record * g_relators_count, balanced_presentation))
+                return static_cast<boost::uint32_t>(s_offsets[level] + record);
+        }
+        
+        // Return 0, balanced_presentation is in no level
+        return 0;
+    }
+    
+    void Frozen_set::get(boost::uint32_t index, Balanced_presentation *balanced_presentation)
+    {
+        // Obtain the level of the index, the last whose offset is below it
+        std::size_t level = std::upper_bound(s_offsets.begin(), s_offsets.end(), static_cast<std::size_t>(index - 1)) - s_offsets.begin() - 1;
+        
+        // Obtain the record of the index in its level
+        std::size_t record = index - s_offsets[level];
+        
+        // Set the relators and parent of balanced_presentation to those of the record
+        for(unsigned int relator = 0; relator < g_relators_count; ++relator)
+            balanced_presentation->set_relator(s_levels[level][record * g_relators_count + relator],relator);
+        balanced_presentation->set_parent(s_parents[level][record]);
+    }
+    
+    void Frozen_set::freeze(std::vector<unsigned int> &records, std::vector<boost::uint64_t> &parents)
+    {
+        // If the level is empty, there is nothing to freeze
+        if(parents.empty())
+            return;
+        
+        // Define the indices of the new records, to sort
+        std::vector<boost::uint32_t> order(parents.size());
+        for(std::size_t record = 0; record < order.size(); ++record)
+            order[record] = static_cast<boost::uint32_t>(record);
+        
+        // Sort the indices of the new records by their records
+        Frozen_record_lesser lesser = { &records[0] };
+        std::sort(order.begin(), order.end(), lesser);
+        
+        // Add a level, with the frozen indices after those of the levels before
+        s_offsets.push_back(s_size);
+        s_levels.push_back(std::vector<unsigned int>((order.size() + 1) * g_relators_count));
+        s_parents.push_back(std::vector<boost::uint64_t>(order.size() + 1));
+        s_size += order.size();
+        
+        // Fill the level, in Eytzinger order, from the sorted records
+        std::size_t next = 0;
+        set_sorted(1, order, records, parents, next);
+        
+        // Free the new records
+        std::vector<unsigned int>().swap(records);
+        std::vector<boost::uint64_t>().swap(parents);
+    }
+    
+    unsigned long Frozen_set::size()
+    {
+        return s_size;
+    }
+    
+    unsigned long Frozen_set::get_bytes()
+    {
+        // Sum the bytes of the records and parents of each level
+        unsigned long bytes = 0;
+        for(std::size_t level = 0; level < s_levels.size(); ++level)
+            bytes += s_levels[level].capacity() * sizeof(unsigned int) + s_parents[level].capacity() * sizeof(boost::uint64_t);
+        
+        // Return the bytes
+        return bytes;
+    }
+    
+    void Frozen_set::clear()
+    {
+        std::vector< std::vector<unsigned int> >().swap(s_levels);
+        std::vector< std::vector<boost::uint64_t> >().swap(s_parents);
+        std::vector<std::size_t>().swap(s_offsets);
+        s_size = 0;
+    }
+    
+    void Frozen_set::set_sorted(std::size_t record, const std::vector<boost::uint32_t> &order, const std::vector<unsigned int> &records, const std::vector<boost::uint64_t> &parents, std::size_t &next)
+    {
+        // If the subtree is empty, there is nothing to fill
+        if(record >= s_parents.back().size())
+            return;
+        
+        // Fill the left subtree, the record, then the right subtree
+        set_sorted(record << 1, order, records, parents, next);
+        std::copy(&records[static_cast<std::size_t>(order[next]) * g_relators_count], &records[static_cast<std::size_t>(order[next]) * g_relators_count] + g_relators_count, &s_levels.back()[record * g_relators_count]);
+        s_parents.back()[record] = parents[order[next]];
+        ++next;
+        set_sorted((record << 1) + 1, order, records, parents, next);
+    }
+    
+    bool is_lesser_frozen_record(const unsigned int *lhs, const unsigned int *rhs)
+    {
+        return std::lexicographical_compare(lhs, lhs + g_relators_count, rhs, rhs + g_relators_count);
+    }
+    
+    bool Frozen_record_lesser::operator()(boost::uint32_t lhs, boost::uint32_t rhs) const
+    {
+        return is_lesser_frozen_record(m_records + static_cast<std::size_t>(lhs) * g_relators_count, m_records + static_cast<std::size_t>(rhs) * g_relators_count);
+    }
+    
+    int compare_frozen_record(const unsigned int *record, const Balanced_presentation *balanced_presentation)
+    {
+        // Compare the ids in turn, the first unequal pair deciding
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+        {
+            unsigned int relator_id = balanced_presentation->get_relator_id(index);
+            if(record[index] != relator_id)
+                return (record[index] < relator_id) ? -1 : 1;
+        }
+        
+        // Return 0, the record is that of balanced_presentation
+        return 0;
+    }
+}
@@ -0,0 +1,150 @@
+//
+//  frozen_set.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_frozen_set_h
+#define Andrews_Curtis_Conjecture_frozen_set_h
+
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+
+namespace andrews_curtis
+{
+    // Forward declarations
+    class Balanced_presentation;
+    
+    ///
+    /// This class encapsulates the functionality of a global, immutable set of
+    /// the presentations of completed levels. A presentation is held as the
+    /// Relator_table ids of its relators, a record, so it is held exactly.
+    ///
+    /// The records of each level are held in an array of their own, sorted and
+    /// in Eytzinger order, the order of a breadth first walk of a complete
+    /// binary search tree, so a lookup is a descent through each array with no
+    /// pointers to follow. A level, once frozen, is never changed, so freezing
+    /// a level only sorts that level. The handle of the parent of each record
+    /// is kept alongside, so a derivation may be followed back through the set
+    /// by the frozen indices of the records. Only freeze() changes the set;
+    /// contains() and find() may be called by many threads at once.
+    ///
+    class Frozen_set
+    {
+    public:
+        ///
+        /// Returns a bool indicating if the passed presentation is in the set
+        ///
+        /// \param balanced_presentation The presentation to look up
+        /// \return A bool indicating if the presentation is in the set
+        ///
+        static bool contains(const Balanced_presentation *balanced_presentation);
+        
+        ///
+        /// Returns the frozen index of the passed presentation, by which it is
+        /// the parent of the presentations of the next level
+        ///
+        /// \param balanced_presentation The presentation to look up
+        /// \return The frozen index of the presentation, 0 if not in the set
+        ///
+        static boost::uint32_t find(const Balanced_presentation *balanced_presentation);
+        
+        ///
+        /// Makes the passed presentation that with the passed frozen index,
+        /// setting its relators and its parent
+        ///
+        /// \param index The frozen index of the presentation, see find()
+        /// \param balanced_presentation Set to the presentation with index
+        ///
+        static void get(boost::uint32_t index, Balanced_presentation *balanced_presentation);
+        
+        ///
+        /// Adds the passed presentations, a completed level, to the set. None
+        /// may already be in the set. No thread may be calling contains().
+        ///
+        /// \param records The ids of the relators of the presentations, one
+        ///                presentation after another
+        /// \param parents The handles of the parents of the presentations, see
+        ///                Balanced_presentation::get_parent_handle()
+        ///
+        static void freeze(std::vector<unsigned int> &records, std::vector<boost::uint64_t> &parents);
+        
+        ///
+        /// Calls the passed function on the ids of each presentation in the set
+        ///
+        /// \param function The function to call, on the ids of a presentation
+        ///
+        template <class Function> static void for_each(Function &function);
+        
+        ///
+        /// Obtains the number of presentations in the set
+        ///
+        /// \return The number of presentations in the set
+        ///
+        static unsigned long size();
+        
+        ///
+        /// Obtains the number of bytes of the records of the set and their
+        /// parents
+        ///
+        /// \return The number of bytes of the records and parents
+        ///
+        static unsigned long get_bytes();
+        
+        ///
+        /// Clears the set of all presentations
+        ///
+        static void clear();
+    
+    
+    private:
+        /// Note: A record is g_relators_count ids, 8 bytes for two relators,
+        /// rather than a 32 byte Balanced_presentation record linked into a
+        /// Binary_tree. Record k of a level's array has its children at 2k and
+        /// 2k+1, record 0 being unused; so, the descent touches the records a
+        /// level apart in the order they are laid out, and prefetches those 4
+        /// levels on, a 64 byte line of 16 records, while comparing.
+        
+        /// Note: The levels are probed newest first, as a child is most often
+        /// found in the level of its parent or the one before. Record k of
+        /// level j has the frozen index s_offsets[j] + k, so the indices of the
+        /// records frozen are never changed by freezing another level.
+        
+        /// The records of each level, in Eytzinger order, from record 1 on
+        static std::vector< std::vector<unsigned int> > s_levels;
+        
+        /// The handles of the parents of the records of each level, in the
+        /// order of the records
+        static std::vector< std::vector<boost::uint64_t> > s_parents;
+        
+        /// The number of presentations of the levels before each level
+        static std::vector<std::size_t> s_offsets;
+        
+        /// The number of presentations in the set
+        static std::size_t s_size;
+    
+    
+    private:
+        //
+        // Fills the records and parents of the last level, in Eytzinger order
+        // from the passed record on, with the passed records in sorted order
+        //
+        // \param record The record of the subtree to fill
+        // \param order The indices of the passed records, in sorted order
+        // \param records The ids of the relators of the records
+        // \param parents The handles of the parents of the records
+        // \param next The next index of order to fill with, advanced
+        //
+        static void set_sorted(std::size_t record, const std::vector<boost::uint32_t> &order, const std::vector<unsigned int> &records, const std::vector<boost::uint64_t> &parents, std::size_t &next);
+    };
+}
+
+#include "frozen_set-inl.h"
+
+#endif
@@ -46,9 +46,64 @@ namespace andrews_curtis
     // of generators has g_generators_count elements, if we
     // include inverses it has 2*g_generators_count elements.
     // This number holds the smallest number of bits required
-    // to represent the number 2*g_generators_count.
+    // to represent the number 2*g_generators_count, rounded
+    // up to a nibble or a byte so no letter straddles a word.
     extern long g_bits_per_letter;
     
+    // As g_bits_per_letter is global, so is the number of
+    // letters packed into a single Relator::Block. Moves
+    // on Relators work on this many letters at a time.
+    extern long g_letters_per_block;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether relators are
+    // identified up to cyclic permutation, i.e. kept
+    // cyclically reduced and in their least rotation, is
+    // the same for all relators. So, it is global too.
+    extern bool g_is_cyclic;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether presentations
+    // are identified up to relator order, relator orient-
+    // ation and generator relabeling is the same for all
+    // presentations. So, it is global too.
+    extern bool g_is_canonical;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether the presentations
+    // found are stored in the concurrent Hash_set, rather
+    // than the Binary_tree, is the same for all of them.
+    // So, it is global too.
+    extern bool g_is_hashed;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether only the
+    // fingerprints of the presentations found are stored,
+    // in the Fingerprint_set, is the same for all of them.
+    // So, it is global too.
+    extern bool g_is_fingerprinted;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether the presentations
+    // found are checked against the Bloom_filter before they
+    // are looked up is the same for all of them. So, it is
+    // global too.
+    extern bool g_is_prefiltered;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether the presentations
+    // found are stored on disk, in the External_store, is the
+    // same for all of them. So, it is global too.
+    extern bool g_is_external;
+    
+    // As the program only works on a single Andrews-Curtis
+    // reduction problem at a time, whether the presentations
+    // of completed levels are frozen into the Frozen_set, or
+    // Succinct_set, leaving only the current level in the
+    // Binary_tree, or Fingerprint_set, is the same for all
+    // of them. So, it is global too.
+    extern bool g_is_frozen;
+    
 }
 
 #endif
@@ -0,0 +1,368 @@
+//
+//  hash_set-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_hash_set_inl_h
+#define Andrews_Curtis_Conjecture_hash_set_inl_h
+
+
+#include <boost/thread/lock_guard.hpp>
+
+
+namespace andrews_curtis
+{
+    // Define Hash_set<T>::s_shards
+    template <class T>
+    typename Hash_set<T>::Shard Hash_set<T>::s_shards[0x1 << Hash_set<T>::s_shard_bits];
+    
+    // Define Hash_set<T>::s_size
+    template <class T>
+    boost::atomic<unsigned long> Hash_set<T>::s_size(0);
+    
+    // Define Hash_set<T>::s_length
+    template <class T>
+    boost::atomic<unsigned long> Hash_set<T>::s_length(0);
+    
+    // The bit of a slot set once its table is frozen
+    static const boost::uint64_t s_frozen_bit = static_cast<boost::uint64_t>(0x1) << 63;
+    
+    // The bits of a slot holding the link to its element
+    static const boost::uint64_t s_link_bits = 0xFFFFFFFF;
+    
+    
+    template <class T>
+    inline T *Hash_set<T>::insert(T *element)
+    {
+        // Obtain the hash of element
+        std::size_t hash = element->get_hash();
+        
+        // Obtain the shard of element
+        Shard &shard = s_shards[hash & ((0x1 << s_shard_bits) - 1)];
+        
+        // Obtain the tag of element
+        boost::uint64_t tag = get_tag(hash);
+        
+        // Obtain the slot value of element
+        boost::uint64_t entry = tag | T::get_link(element);
+        
+        // Loop over tables of the shard, the current one first
+        for(Table *table = get_table(shard); true; table = grow(shard, table))
+        {
+            // Obtain the mask of a slot
+            std::size_t mask = table->m_capacity - 1;
+            
+            // Loop over slots, starting from the one picked by the hash (Note: the
+            // table is at most half full, else a thread is growing it; so, if all
+            // slots are probed, wait for the new table)
+            std::size_t slot = (hash >> s_shard_bits) & mask;
+            for(std::size_t probes = 0; probes < table->m_capacity; )
+            {
+                // Obtain the value of the slot
+                boost::uint64_t value = table->m_slots[slot].load(boost::memory_order_acquire);
+                
+                // If the table is frozen, wait for the new table
+                if(value & s_frozen_bit)
+                    break;
+                
+                // If the slot is empty, element is not in the table; claim the slot
+                if(!value)
+                {
+                    // If another thread claimed the slot first, re-examine the slot
+                    if(!table->m_slots[slot].compare_exchange_strong(value, entry, boost::memory_order_acq_rel))
+                        continue;
+                    
+                    // Increment s_size and s_length
+                    s_size.fetch_add(1, boost::memory_order_relaxed);
+                    s_length.fetch_add(element->get_length(), boost::memory_order_relaxed);
+                    
+                    // Grow the table if more than half its slots are occupied
+                    if((2 * (shard.m_size.fetch_add(1, boost::memory_order_relaxed) + 1)) > table->m_capacity)
+                        grow(shard, table);
+                    
+                    // Return 0 indicating the element was inserted
+                    return 0;
+                }
+                
+                // If the slot holds element, return the element already there
+                if(((value & ~s_link_bits) == tag) && (*element == *T::get_linked(static_cast<boost::uint32_t>(value))))
+                    return T::get_linked(static_cast<boost::uint32_t>(value));
+                
+                // Continue to the next slot
+                slot = (slot + 1) & mask;
+                ++probes;
+            }
+        }
+    }
+    
+    template <class T>
+    inline T *Hash_set<T>::find(const T *element)
+    {
+        // Obtain the hash of element
+        std::size_t hash = element->get_hash();
+        
+        // Obtain the shard of element
+        Shard &shard = s_shards[hash & ((0x1 << s_shard_bits) - 1)];
+        
+        // Obtain the tag of element
+        boost::uint64_t tag = get_tag(hash);
+        
+        // Loop over tables of the shard, the current one first
+        for(Table *table = get_table(shard); true; table = grow(shard, table))
+        {
+            // Obtain the mask of a slot
+            std::size_t mask = table->m_capacity - 1;
+            
+            // Loop over slots, starting from the one picked by the hash
+            std::size_t slot = (hash >> s_shard_bits) & mask;
+            for(std::size_t probes = 0; probes < table->m_capacity; ++probes, slot = (slot + 1) & mask)
+            {
+                // Obtain the value of the slot
+                boost::uint64_t value = table->m_slots[slot].load(boost::memory_order_acquire);
+                
+                // If the table is frozen, wait for the new table
+                if(value & s_frozen_bit)
+                    break;
+                
+                // If the slot is empty, element is not in the hash set
+                if(!value)
+                    return 0;
+                
+                // If the slot holds element, return the element
+                if(((value & ~s_link_bits) == tag) && (*element == *T::get_linked(static_cast<boost::uint32_t>(value))))
+                    return T::get_linked(static_cast<boost::uint32_t>(value));
+            }
+        }
+    }
+    
+    template <class T>
+    inline unsigned long Hash_set<T>::size()
+    {
+        return s_size.load();
+    }
+    
+    template <class T>
+    inline unsigned long Hash_set<T>::length()
+    {
+        return s_length.load();
+    }
+    
+    template <class T>
+    template <class Function>
+    void Hash_set<T>::for_each(Function &function)
+    {
+        // Loop over shards
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Obtain the current table of the shard, which holds all its elements
+            Table *table = s_shards[index].m_table.load(boost::memory_order_acquire);
+            
+            // Loop over the slots, calling function on the element in each, if any
+            for(std::size_t slot = 0; table && (slot < table->m_capacity); ++slot)
+            {
+                // Obtain the link in the slot
+                boost::uint32_t link = static_cast<boost::uint32_t>(table->m_slots[slot].load(boost::memory_order_relaxed));
+                
+                // Call function on the element in the slot, if any
+                if(link)
+                    function(static_cast<const T*>(T::get_linked(link)));
+            }
+        }
+    }
+    
+    template <class T>
+    void Hash_set<T>::clear()
+    {
+        clear(true);
+    }
+    
+    template <class T>
+    void Hash_set<T>::detach()
+    {
+        clear(false);
+    }
+    
+    template <class T>
+    void Hash_set<T>::reclaim()
+    {
+        // Loop over shards, freeing the tables each outgrew
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Obtain the shard
+            Shard &shard = s_shards[index];
+            
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+            
+            // Obtain the current table of the shard, if any
+            Table *table = shard.m_table.load();
+            if(!table)
+                continue;
+            
+            // Delete the tables it replaced
+            for(Table *retired = table->m_retired; retired; )
+            {
+                Table *next = retired->m_retired;
+                delete[] retired->m_slots;
+                delete retired;
+                retired = next;
+            }
+            
+            // The current table now replaced none
+            table->m_retired = 0;
+        }
+    }
+    
+    template <class T>
+    void Hash_set<T>::clear(bool is_deleting)
+    {
+        // Loop over shards, emptying each
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Obtain the shard
+            Shard &shard = s_shards[index];
+            
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+            
+            // Obtain the current table of the shard
+            Table *table = shard.m_table.load();
+            
+            // Delete the elements, all of which are in the current table, unless they outlive the hash set
+            for(std::size_t slot = 0; is_deleting && table && (slot < table->m_capacity); ++slot)
+            {
+                // Obtain the value of the slot
+                boost::uint32_t link = static_cast<boost::uint32_t>(table->m_slots[slot].load());
+                
+                // Delete the element in the slot, if any
+                if(link)
+                    delete T::get_linked(link);
+            }
+            
+            // Delete the current table and the tables it replaced
+            while(table)
+            {
+                Table *retired = table->m_retired;
+                delete[] table->m_slots;
+                delete table;
+                table = retired;
+            }
+            
+            // Reset the shard
+            shard.m_table.store(0);
+            shard.m_size.store(0);
+        }
+        
+        // Reset s_size
+        s_size.store(0);
+        
+        // Reset s_length
+        s_length.store(0);
+    }
+    
+    template <class T>
+    inline boost::uint64_t Hash_set<T>::get_tag(std::size_t hash)
+    {
+        return (static_cast<boost::uint64_t>(hash) >> 33) << 32;
+    }
+    
+    template <class T>
+    inline typename Hash_set<T>::Table *Hash_set<T>::get_table(Shard &shard)
+    {
+        // Obtain the current table
+        Table *table = shard.m_table.load(boost::memory_order_acquire);
+        
+        // If the shard has a table, return it
+        if(table)
+            return table;
+        
+        // Lock the shard's mutex
+        boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+        
+        // Obtain the current table, another thread may have created it
+        table = shard.m_table.load(boost::memory_order_acquire);
+        
+        // If the shard has no table, create its first
+        if(!table)
+        {
+            // New up the table, empty
+            table = new Table();
+            table->m_capacity = s_first_capacity;
+            table->m_slots = new boost::atomic<boost::uint64_t>[s_first_capacity];
+            table->m_retired = 0;
+            for(std::size_t slot = 0; slot < s_first_capacity; ++slot)
+                table->m_slots[slot].store(0, boost::memory_order_relaxed);
+            
+            // Publish the table
+            shard.m_table.store(table, boost::memory_order_release);
+        }
+        
+        // Return the table
+        return table;
+    }
+    
+    template <class T>
+    typename Hash_set<T>::Table *Hash_set<T>::grow(Shard &shard, Table *table)
+    {
+        // Lock the shard's mutex, waiting for any thread growing the shard
+        boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+        
+        // If table was already replaced, return the current table
+        Table *current = shard.m_table.load(boost::memory_order_acquire);
+        if(current != table)
+            return current;
+        
+        // Freeze the slots of table, so no thread may claim them
+        for(std::size_t slot = 0; slot < table->m_capacity; ++slot)
+        {
+            // Set the frozen bit, retrying if a thread claims the slot meanwhile
+            boost::uint64_t value = table->m_slots[slot].load(boost::memory_order_acquire);
+            while(!table->m_slots[slot].compare_exchange_weak(value, value | s_frozen_bit, boost::memory_order_acq_rel))
+                ;
+        }
+        
+        // New up a table of twice the slots, empty
+        Table *grown = new Table();
+        grown->m_capacity = 2 * table->m_capacity;
+        grown->m_slots = new boost::atomic<boost::uint64_t>[grown->m_capacity];
+        grown->m_retired = table;
+        for(std::size_t slot = 0; slot < grown->m_capacity; ++slot)
+            grown->m_slots[slot].store(0, boost::memory_order_relaxed);
+        
+        // Obtain the mask of a slot of the new table
+        std::size_t mask = grown->m_capacity - 1;
+        
+        // Loop over the occupied slots of table, copying each to the new table
+        for(std::size_t index = 0; index < table->m_capacity; ++index)
+        {
+            // Obtain the value of the slot, without the frozen bit
+            boost::uint64_t value = table->m_slots[index].load(boost::memory_order_relaxed) & ~s_frozen_bit;
+            
+            // Skip empty slots
+            if(!value)
+                continue;
+            
+            // Obtain the hash of the element in the slot
+            std::size_t hash = T::get_linked(static_cast<boost::uint32_t>(value))->get_hash();
+            
+            // Find the first empty slot, starting from the one picked by the hash
+            std::size_t slot = (hash >> s_shard_bits) & mask;
+            while(grown->m_slots[slot].load(boost::memory_order_relaxed))
+                slot = (slot + 1) & mask;
+            
+            // Copy the value into the slot
+            grown->m_slots[slot].store(value, boost::memory_order_relaxed);
+        }
+        
+        // Publish the new table
+        shard.m_table.store(grown, boost::memory_order_release);
+        
+        // Return the new table
+        return grown;
+    }
+}
+
+#endif
@@ -0,0 +1,178 @@
+//
+//  hash_set.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_hash_set_h
+#define Andrews_Curtis_Conjecture_hash_set_h
+
+
+#include <cstddef>
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+
+
+namespace andrews_curtis
+{
+    ///
+    /// This class encapsulates the functionality of a global, concurrent hash
+    /// set. It has the contract of Binary_tree, insert(), find(), size(),
+    /// length() and clear(), but inserts and finds take no lock.
+    ///
+    /// The passed type T must have operator==, a method get_hash() returning
+    /// the hash of an element, a method get_length(), and static methods
+    /// get_link(const T*) and get_linked(boost::uint32_t) mapping an element
+    /// to a non-zero 32 bit link and back.
+    ///
+    template <class T>
+    class Hash_set
+    {
+    public:
+        ///
+        /// Inserts an element into the hash set. This method returns 0 if
+        /// the inserted element was not previously in the hash set. If the
+        /// element was already in the hash set, then a pointer to the
+        /// element already in the hash set is returned.
+        ///
+        /// \param element The element to insert into the Hash_set
+        /// \return The equivalent instance already in the hash set or 0
+        ///
+        static T *insert(T *element);
+        
+        ///
+        /// Finds an element in the hash set, without inserting it. This
+        /// method returns a pointer to the equivalent element in the hash
+        /// set, or 0 if there is no such element.
+        ///
+        /// \param element The element to find in the Hash_set
+        /// \return The equivalent instance in the hash set or 0
+        ///
+        static T *find(const T *element);
+        
+        ///
+        /// Obtains the size of this hash set
+        ///
+        /// \return The size of this hash set
+        ///
+        static unsigned long size();
+        
+        ///
+        /// Obtains the length of this hash set
+        ///
+        /// \return The length of this hash set
+        ///
+        static unsigned long length();
+        
+        ///
+        /// Calls the passed function on each element of the hash set. No
+        /// thread may be inserting.
+        ///
+        /// \param function The function to call, on a const T*
+        ///
+        template <class Function> static void for_each(Function &function);
+        
+        ///
+        /// Clear the hash set of all elements and calls the destructor of
+        /// each contained element. No thread may be inserting or finding.
+        ///
+        static void clear();
+        
+        ///
+        /// Empties the hash set, freeing its tables but calling the destructor
+        /// of no element, so the elements outlive the hash set. No thread may
+        /// be inserting or finding.
+        ///
+        static void detach();
+        
+        ///
+        /// Frees the tables the shards have outgrown, which are kept while a
+        /// thread may still be probing them. No thread may be inserting or
+        /// finding.
+        ///
+        static void reclaim();
+    
+    
+    private:
+        /// The number of bits of a hash picking the shard of an element
+        static const unsigned int s_shard_bits = 6;
+        
+        /// The number of slots of the first table of a shard
+        static const std::size_t s_first_capacity = 0x1 << 10;
+        
+        ///
+        /// A table of a shard, an open addressing hash table, with linear
+        /// probing. A slot holds 0, if empty, or a tag of the hash of its
+        /// element in bits 32 to 62 and the link to its element in bits 0
+        /// to 31. Bit 63 of a slot is set once the table is frozen.
+        ///
+        struct Table
+        {
+            /// The number of slots, a power of 2
+            std::size_t m_capacity;
+            
+            /// The slots
+            boost::atomic<boost::uint64_t> *m_slots;
+            
+            /// The table this table replaced, freed by reclaim() or clear()
+            Table *m_retired;
+        };
+        
+        ///
+        /// A shard of the hash set, whose elements are those whose hash picks
+        /// the shard
+        ///
+        struct Shard
+        {
+            /// The current table of the shard, 0 until the first insert
+            boost::atomic<Table*> m_table;
+            
+            /// The number of elements in the shard
+            boost::atomic<unsigned long> m_size;
+            
+            /// Mutex for replacing the table
+            boost::mutex m_mutex;
+        };
+        
+        /// Note: An element is inserted by a compare-and-swap on an empty slot,
+        /// so threads insert into a table concurrently. A table is only ever
+        /// replaced when more than half its slots are occupied: the growing
+        /// thread freezes every slot, so no insert can slip into the table,
+        /// copies the elements to a table of twice the slots, and publishes it.
+        /// Threads meeting a frozen slot wait on the shard's mutex for the new
+        /// table; so, only the rare inserts racing a growth of their shard wait.
+        
+        /// The shards
+        static Shard s_shards[0x1 << s_shard_bits];
+        
+        /// The size of the hash set
+        static boost::atomic<unsigned long> s_size;
+        
+        /// The length of the hash set's elements
+        static boost::atomic<unsigned long> s_length;
+    
+    
+    private:
+        /// Utility function returning the tag of a hash, bits 32 to 62 of a slot
+        static boost::uint64_t get_tag(std::size_t hash);
+        
+        /// Utility function returning the table of a shard, creating it if need be
+        static Table *get_table(Shard &shard);
+        
+        /// Utility function replacing the passed table of a shard, if it is still
+        /// its table, with a table of twice the slots, returning the new table
+        static Table *grow(Shard &shard, Table *table);
+        
+        /// Utility function used by clear and detach, emptying the shards and
+        /// deleting their elements if is_deleting
+        static void clear(bool is_deleting);
+    };
+}
+
+#include "hash_set-inl.h"
+
+#endif
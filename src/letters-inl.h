@@ -10,177 +10,104 @@
 #define Andrews_Curtis_Conjecture_letters_inl_h
 
 
-#include <map>
-
 #include "globals.h"
 
 
 namespace andrews_curtis
 {
-    static const bool bools[52][5] =
-    {
-        {true , false, false, false, false},  // 'a' 1
-        {false, true , false, false, false},  // 'b' 2
-        {true , true , false, false, false},  // 'c' 3
-        {false, false, true , false, false},  // 'd' 4
-        {true , false, true , false, false},  // 'e' 5
-        {false, true , true , false, false},  // 'f' 6
-        {true , true , true , false, false},  // 'g' 7
-        {false, false, false, true , false},  // 'h' 8
-        {true , false, false, true , false},  // 'i' 9
-        {false, true , false, true , false},  // 'j' 10
-        {true , true , false, true , false},  // 'k' 11
-        {false, false, true , true , false},  // 'l' 12
-        {true , false, true , true , false},  // 'm' 13
-        {false, true , true , true , false},  // 'n' 14
-        {true , true , true , true , false},  // 'o' 15
-        {false, false, false, false, true },  // 'p' 16
-        {true , false, false, false, true },  // 'q' 17
-        {false, true , false, false, true },  // 'r' 18
-        {true , true , false, false, true },  // 's' 19
-        {false, false, true , false, true },  // 't' 20
-        {true , false, true , false, true },  // 'u' 21
-        {false, true , true , false, true },  // 'v' 22
-        {true , true , true , false, true },  // 'w' 23
-        {false, false, false, true , true },  // 'x' 24
-        {true , false, false, true , true },  // 'y' 25
-        {false, true , false, true , true },  // 'z' 26
-        {false, true , true , true , true },  // 'A' ~1
-        {true , false, true , true , true },  // 'B' ~2
-        {false, false, true , true , true },  // 'C' ~3
-        {true , true , false, true , true },  // 'D' ~4
-        {false, true , false, true , true },  // 'E' ~5
-        {true , false, false, true , true },  // 'F' ~6
-        {false, false, false, true , true },  // 'g' ~7
-        {true , true , true , false, true },  // 'H' ~8
-        {false, true , true , false, true },  // 'I' ~9
-        {true , false, true , false, true },  // 'J' ~10
-        {false, false, true , false, true },  // 'K' ~11
-        {true , true , false, false, true },  // 'L' ~12
-        {false, true , false, false, true },  // 'M' ~13
-        {true , false, false, false, true },  // 'N' ~14
-        {false, false, false, false, true },  // 'O' ~15
-        {true , true , true , true , false},  // 'P' ~16
-        {false, true , true , true , false},  // 'Q' ~17
-        {true , false, true , true , false},  // 'R' ~18
-        {false, false, true , true , false},  // 'S' ~19
-        {true , true , false, true , false},  // 'T' ~20
-        {false, true , false, true , false},  // 'U' ~21
-        {true , false, false, true , false},  // 'V' ~22
-        {false, false, false, true , false},  // 'W' ~23
-        {true , true , true , false, false},  // 'X' ~24
-        {false, true , true , false, false},  // 'Y' ~25
-        {true , false, true , false, false},  // 'Z' ~26
-    };
-    
-    inline const bool *Letters::get_bools(int index)
+    inline unsigned int Letters::get_generator_bits(int generator)
     {
-        // Offset index properly
-        if(index < 0)
-            index = 25 - index;
-        else
-            index -= 1;
+        // Obtain the generator in one's compliment
+        unsigned int bits = (generator < 0) ? ~static_cast<unsigned int>(-generator) : generator;
         
-        // Return the array of bools
-        return bools[index];
+        // Return the g_bits_per_letter least significant bits
+        return bits & ((0x1 << g_bits_per_letter) - 1);
     }
     
     
-    // Utility class to map a char to its corresponding bits. Each
-    // char has a number ...C=-3,B=-2,A=-1,a=1,b=2,c=3,... the bits
-    // is this number in one's compliment.
-    class Char_to_bits
+    // Note: The tables below are constant initialized, so they are in place
+    //       before any code runs and a lookup is a single indexed load. The
+    //       bits of a letter are its number ...B=-2,A=-1,a=1,b=2... in one's
+    //       compliment; so, the bits of the inverse of a letter are the bits
+    //       of the letter xor'ed with all ones, see Letters::get_inverse().
+    
+    // The bits, 8 bits wide, of each char, 0 for a char that is not a letter
+    static const unsigned char s_char_to_bits[256] =
     {
-    public:
-        Char_to_bits()
-        {
-            m_map['a'] =  0x01;
-            m_map['b'] =  0x02;
-            m_map['c'] =  0x03;
-            m_map['d'] =  0x04;
-            m_map['e'] =  0x05;
-            m_map['f'] =  0x06;
-            m_map['g'] =  0x07;
-            m_map['h'] =  0x08;
-            m_map['i'] =  0x09;
-            m_map['j'] =  0x0A;
-            m_map['k'] =  0x0B;
-            m_map['l'] =  0x0C;
-            m_map['m'] =  0x0D;
-            m_map['n'] =  0x0E;
-            m_map['o'] =  0x0F;
-            m_map['p'] =  0x10;
-            m_map['q'] =  0x11;
-            m_map['r'] =  0x12;
-            m_map['s'] =  0x13;
-            m_map['t'] =  0x14;
-            m_map['u'] =  0x15;
-            m_map['v'] =  0x16;
-            m_map['w'] =  0x17;
-            m_map['x'] =  0x18;
-            m_map['y'] =  0x19;
-            m_map['z'] =  0x1A;
-            m_map['A'] =  0xFE;
-            m_map['B'] =  0xFD;
-            m_map['C'] =  0xFC;
-            m_map['D'] =  0xFB;
-            m_map['E'] =  0xFA;
-            m_map['F'] =  0xF9;
-            m_map['G'] =  0xF8;
-            m_map['H'] =  0xF7;
-            m_map['I'] =  0xF6;
-            m_map['J'] =  0xF5;
-            m_map['K'] =  0xF4;
-            m_map['L'] =  0xF3;
-            m_map['M'] =  0xF2;
-            m_map['N'] =  0xF1;
-            m_map['O'] =  0xF0;
-            m_map['P'] =  0xEF;
-            m_map['Q'] =  0xEE;
-            m_map['R'] =  0xED;
-            m_map['S'] =  0xEC;
-            m_map['T'] =  0xEB;
-            m_map['U'] =  0xEA;
-            m_map['V'] =  0xE9;
-            m_map['W'] =  0xE8;
-            m_map['X'] =  0xE7;
-            m_map['Y'] =  0xE6;
-            m_map['Z'] =  0xE5;
-        }
-        
-        const unsigned int &get_bits(const char &letter)
-        {
-            return m_map[letter];
-        }
-        
-    private:
-        std::map<char,unsigned int> m_map;
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0xFE, 0xFD, 0xFC, 0xFB, 0xFA, 0xF9, 0xF8, 0xF7, 0xF6, 0xF5, 0xF4, 0xF3, 0xF2, 0xF1, 0xF0,
+        0xEF, 0xEE, 0xED, 0xEC, 0xEB, 0xEA, 0xE9, 0xE8, 0xE7, 0xE6, 0xE5, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+    
+    // The char of the bits of each letter 4 bits wide, '?' for bits that are not a letter
+    static const char s_bits_to_char_4[16] =
+    {
+        '?', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'G', 'F', 'E', 'D', 'C', 'B', 'A', '?'
+    };
+    
+    // The char of the bits of each letter 8 bits wide, '?' for bits that are not a letter
+    static const char s_bits_to_char_8[256] =
+    {
+        '?', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o',
+        'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?',
+        '?', '?', '?', '?', '?', 'Z', 'Y', 'X', 'W', 'V', 'U', 'T', 'S', 'R', 'Q', 'P',
+        'O', 'N', 'M', 'L', 'K', 'J', 'I', 'H', 'G', 'F', 'E', 'D', 'C', 'B', 'A', '?'
     };
     
+    inline unsigned int Letters::get_inverse(unsigned int bits)
+    {
+        return bits ^ ((0x1 << g_bits_per_letter) - 1);
+    }
+    
     inline char Letters::get_letter(unsigned int bits)
-    {   
-        // Determine if bits is negative (One's compliment)
-        if(bits & (0x1 << (g_bits_per_letter - 1)))
-        {
-            // Flip the bits of bits
-            bits = ~bits;
-            
-            // Return a upper case letter
-            return bits + 72;
-        }
-        
-        // Return a lower case letter
-        return bits + 96;
+    {
+        // Dispatch to the letter width
+        return (4 == g_bits_per_letter) ? get_letter<4>(bits) : get_letter<8>(bits);
+    }
+    
+    template <unsigned int Bits>
+    inline char Letters::get_letter(unsigned int bits)
+    {
+        // Look up the char in the table for the letter width
+        return (4 == Bits) ? s_bits_to_char_4[bits & 0xF] : s_bits_to_char_8[bits & 0xFF];
     }
     
+    inline unsigned int Letters::get_bits(char letter)
+    {
+        // Dispatch to the letter width
+        return (4 == g_bits_per_letter) ? get_bits<4>(letter) : get_bits<8>(letter);
+    }
     
-    inline const unsigned int &Letters::get_bits(const char &letter)
+    template <unsigned int Bits>
+    inline unsigned int Letters::get_bits(char letter)
     {
-        // Construct Char_to_bits statically
-        static Char_to_bits map;
-        
-        // Return the apropos bits
-        return map.get_bits(letter);
+        // Look up the bits of letter, keeping the Bits least significant
+        return s_char_to_bits[static_cast<unsigned char>(letter)] & ((0x1 << Bits) - 1);
     }
 }
 
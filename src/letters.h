@@ -20,17 +20,24 @@ namespace andrews_curtis
     {
     public:
         //
-        // Returns an array of bools that represents the passed letter. The passed
-        // number identifies a letter as follows: ...B=-2,A=-1,a=1,b=1... each one
-        // of these numbers can be expressed in one's compliment in hexidecimal as
-        // follows ...B=0xFD,A=0xFE,a=0x01,b=0x02... and in binary...B=0b11111101,
-        // A=0b11111110,a=0b00000001,b=...  These binary numbers can be viewed as
-        // arrays of bools with length g_bits_per_letter. This method returns such
-        // an arrary.
-        //
-        // \param index The index of the letter to return
-        // \return An array of bool's representing the selected letter
-        static const bool *get_bools(int index);
+        // Returns the bits representing the passed generator. The passed number
+        // identifies a letter as follows: ...B=-2,A=-1,a=1,b=2... each one of
+        // these numbers can be expressed in one's compliment in hexidecimal as
+        // follows ...B=0xFD,A=0xFE,a=0x01,b=0x02... This method returns the
+        // g_bits_per_letter least significant bits of this one's compliment.
+        //
+        // \param generator The generator to return the bits of
+        // \return The bits representing the passed generator
+        static unsigned int get_generator_bits(int generator);
+        
+        //
+        // Returns the bits representing the inverse of the letter represented
+        // by the passed bits. As the bits are in one's compliment, this is the
+        // passed bits xor'ed with g_bits_per_letter ones.
+        //
+        // \param bits The bits of the letter to invert
+        // \return The bits of the inverse of the letter
+        static unsigned int get_inverse(unsigned int bits);
         
         //
         // Returns the char corresponding to the passed bits
@@ -40,12 +47,29 @@ namespace andrews_curtis
         static char get_letter(unsigned int bits);
         
         //
-        // Returns a (const unsigned int&) that has its g_bits_per_letter least
+        // Returns the char corresponding to the passed bits, for letters of
+        // Bits bits. This is a lookup in a table of 2^Bits chars.
+        //
+        // \param bits The bits to convert to a char
+        // \return The corresponsing char
+        template <unsigned int Bits> static char get_letter(unsigned int bits);
+        
+        //
+        // Returns an unsigned int that has its g_bits_per_letter least
         // significant bits set to the bits representing the passed letter.
         //
         // \param letter The letter to convert to bits
         // \return The passed letter represented as bits
-        static const unsigned int &get_bits(const char &letter);
+        static unsigned int get_bits(char letter);
+        
+        //
+        // Returns an unsigned int that has its Bits least significant bits
+        // set to the bits representing the passed letter. This is a lookup
+        // in a table of 256 bits, one per char.
+        //
+        // \param letter The letter to convert to bits
+        // \return The passed letter represented as bits
+        template <unsigned int Bits> static unsigned int get_bits(char letter);
     };
 }
 
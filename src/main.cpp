@@ -10,8 +10,16 @@
 #include <boost/mpi/environment.hpp>
 
 #include "relator.h"
+#include "globals.h"
 #include "searcher.h"
+#include "relator_table.h"
 #include "arguments.h"
+#include "hash_set.h"
+#include "fingerprint_set.h"
+#include "bloom_filter.h"
+#include "external_store.h"
+#include "frozen_set.h"
+#include "succinct_set.h"
 #include "binary_tree.h"
 #include "balanced_presentation.h"
 
@@ -53,11 +61,40 @@ int main (int argc,char * argv[])
         searcher.print_counterexample();
     }
     
-    // Clean up Relators
-    Binary_tree<Relator>::clear();
+    // In fast exit mode the results are out, so skip the teardown, the system reclaims the memory at exit (Note: the External_store's files are left)
+    if(arguments.is_fast_exit())
+    {
+        // Flush the results
+        std::cout << std::flush;
+        
+        // Return success
+        return 0;
+    }
+    
+    // Clean up Relators, then free the chunks and index of the Relator_table
+    Relator_table::clear();
+    Relator_table::release();
+    
+    // Clean up Balanced_presentation's (Note: their destructor does nothing, so the Hash_set and Binary_tree only let go of them, they are returned with the slabs)
+    if(g_is_fingerprinted)
+        Fingerprint_set<Balanced_presentation>::clear();
+    else if(g_is_hashed)
+        Hash_set<Balanced_presentation>::detach();
+    else if(g_is_external)
+        External_store::clear();
+    else
+        Binary_tree<Balanced_presentation>::detach();
+    
+    // Free the Frozen_set or Succinct_set, if any
+    Frozen_set::clear();
+    Succinct_set::clear();
+    
+    // Free the Bloom_filter, if any
+    Bloom_filter::clear();
     
-    // Clean up Balanced_presentation's
-    Binary_tree<Balanced_presentation>::clear();
+    // Return the slabs of Balanced_presentation's and Relators in bulk
+    Balanced_presentation::release();
+    Relator::release();
     
     // Return success
     return 0;
@@ -10,12 +10,9 @@
 #define Andrews_Curtis_Conjecture_relator_inl_h
 
 
-#include <vector>
-#include <limits>
 #include <cstring>
 
-#include <boost/functional/hash.hpp>
-#include <boost/serialization/vector.hpp>
+#include <boost/serialization/array_wrapper.hpp>
 
 #include "globals.h"
 #include "letters.h"
@@ -24,47 +21,95 @@
 namespace andrews_curtis
 {
     inline Relator::Relator()
-    :   m_relator(),
-        m_left(0),
-        m_right(0)
+    :   m_hash(0),
+        m_inverse_hash(0),
+        m_length(0),
+        m_capacity(0)
     {
     }
     
     inline Relator::Relator(const char *relator)
-    :   m_relator(std::strlen(relator) * g_bits_per_letter),
-        m_left(0),
-        m_right(0)
+    :   m_hash(0),
+        m_inverse_hash(0),
+        m_length(0),
+        m_capacity(0)
     {
-        // Loop over letters in relator
-        for(size_t index = 0; index < std::strlen(relator); ++index)
-        {
-            // Obtain bits in letter at index
-            const unsigned int &bits_in_letter =  Letters::get_bits(relator[index]);
-            
-            // Loop over bits in letter
-            for(unsigned int bit = 0; bit < g_bits_per_letter; ++bit)
-            {
-                // Set apropos m_relator bit to bit of next_letter (Note: does not allocate)
-                m_relator[index*g_bits_per_letter + bit] = (bits_in_letter >> bit) & 0x1;
-            }
-        }
+        // Obtain the number of letters in relator
+        size_t length = std::strlen(relator);
+        
+        // Resize to hold length letters (Note: may allocate)
+        resize(length);
+        
+        // Set the letters to the bits of the chars of relator, dispatching to the letter width
+        if(4 == g_bits_per_letter)
+            set_letters<4>(relator);
+        else
+            set_letters<8>(relator);
+        
+        // Compute the hashes of the letters
+        rehash();
+    }
+    
+    inline Relator::Relator(const Relator &relator)
+    :   m_hash(0),
+        m_inverse_hash(0),
+        m_length(0),
+        m_capacity(0)
+    {
+        // Copy the letters of relator
+        *this = relator;
+    }
+    
+    inline Relator::~Relator()
+    {
+        // Free any heap allocated Blocks
+        if(m_capacity)
+            free_blocks(m_heap_blocks, m_capacity);
     }
     
     inline size_t Relator::get_length() const
     {
-        return (m_relator.size() / g_bits_per_letter);
+        return m_length;
+    }
+    
+    inline size_t Relator::get_bytes() const
+    {
+        return sizeof(Relator) + m_capacity * sizeof(Block);
+    }
+    
+    inline boost::uint64_t Relator::get_inverse_hash() const
+    {
+        return m_inverse_hash;
+    }
+    
+    inline void Relator::add_to_fingerprint(boost::uint64_t &high, boost::uint64_t &low) const
+    {
+        // Obtain the Blocks holding the letters
+        const Block *blocks = get_blocks();
+        
+        // Mix in the length, keeping the letters of consecutive Relators apart, then the Blocks
+        for(size_t index = 0; index <= get_block_count(); ++index)
+        {
+            // Obtain the word to mix in, the length then each Block
+            boost::uint64_t word = index ? blocks[index - 1] : m_length;
+            
+            // Mix the word into the high half, with the finalizer of MurmurHash3, so each bit of it reaches every bit
+            high ^= word + 0x9E3779B97F4A7C15ull;
+            high = (high ^ (high >> 33)) * 0xFF51AFD7ED558CCDull;
+            high = (high ^ (high >> 33)) * 0xC4CEB9FE1A85EC53ull;
+            high ^= high >> 33;
+            
+            // Mix the word, and the high half, into the low half, from another seed
+            low = (low ^ (word + 0xC2B2AE3D27D4EB4Full)) + high;
+            low = (low ^ (low >> 33)) * 0xFF51AFD7ED558CCDull;
+            low = (low ^ (low >> 33)) * 0xC4CEB9FE1A85EC53ull;
+            low ^= low >> 33;
+        }
     }
     
     inline Relator::operator std::size_t() const
 	{
-		// Define hash
-		boost::hash<std::string> hash;
-		
-		// Obtain string
-		std::string string = to_string();
-		
-		// Return result
-		return hash(string);
+		return m_hash;
 	}
     
     inline std::string Relator::to_string() const
@@ -72,26 +117,140 @@ namespace andrews_curtis
         // Define the string
         std::string relator;
         
-        // Loop over letters in m_relator
-        for(unsigned int letter = 0; letter < (m_relator.size() / g_bits_per_letter); ++letter)
+        // Reserve space for the letters (Note: may allocate)
+        relator.reserve(m_length);
+        
+        // Append the chars of the letters, dispatching to the letter width
+        if(4 == g_bits_per_letter)
+            append_letters<4>(relator);
+        else
+            append_letters<8>(relator);
+        
+        // Return relator
+        return relator;
+    }
+    
+    inline Relator::Block *Relator::get_blocks()
+    {
+        return m_capacity ? m_heap_blocks : m_inline_blocks;
+    }
+    
+    inline const Relator::Block *Relator::get_blocks() const
+    {
+        return m_capacity ? m_heap_blocks : m_inline_blocks;
+    }
+    
+    inline size_t Relator::get_block_count() const
+    {
+        return (m_length + g_letters_per_block - 1) / g_letters_per_block;
+    }
+    
+    inline unsigned int Relator::get_letter(size_t index) const
+    {
+        // Dispatch to the letter width
+        return (4 == g_bits_per_letter) ? get_letter<4>(index) : get_letter<8>(index);
+    }
+    
+    template <unsigned int Bits>
+    inline unsigned int Relator::get_letter(size_t index) const
+    {
+        // Obtain the number of letters in a Block
+        const unsigned int letters_per_block = s_bits_per_block / Bits;
+        
+        // Obtain the Block holding the letter at index
+        const Block &block = get_blocks()[index / letters_per_block];
+        
+        // Shift the letter down and mask off the letters above it
+        return (block >> ((index % letters_per_block) * Bits)) & ((0x1 << Bits) - 1);
+    }
+    
+    inline void Relator::set_letter(size_t index, unsigned int bits)
+    {
+        // Dispatch to the letter width
+        if(4 == g_bits_per_letter)
+            set_letter<4>(index, bits);
+        else
+            set_letter<8>(index, bits);
+    }
+    
+    template <unsigned int Bits>
+    inline void Relator::set_letter(size_t index, unsigned int bits)
+    {
+        // Obtain the number of letters in a Block
+        const unsigned int letters_per_block = s_bits_per_block / Bits;
+        
+        // Or the bits into the apropos position of the apropos Block
+        get_blocks()[index / letters_per_block] |= static_cast<Block>(bits) << ((index % letters_per_block) * Bits);
+    }
+    
+    template <unsigned int Bits>
+    inline void Relator::set_letters(const char *relator)
+    {
+        // Loop over letters in relator
+        for(size_t index = 0; index < m_length; ++index)
+        {
+            // Set the letter at index to the bits of relator[index]
+            set_letter<Bits>(index, Letters::get_bits<Bits>(relator[index]));
+        }
+    }
+    
+    template <unsigned int Bits>
+    inline void Relator::append_letters(std::string &relator) const
+    {
+        // Loop over letters in this Relator
+        for(size_t index = 0; index < m_length; ++index)
+        {
+            // Append letter
+            relator += Letters::get_letter<Bits>(get_letter<Bits>(index));
+        }
+    }
+    
+    inline void Relator::resize(size_t length)
+    {
+        // Obtain the number of Blocks currently used
+        size_t old_block_count = get_block_count();
+        
+        // Obtain the number of Blocks needed to hold length letters
+        size_t block_count = (length + g_letters_per_block - 1) / g_letters_per_block;
+        
+        // Obtain the number of Blocks currently held
+        size_t capacity = m_capacity ? m_capacity : s_inline_blocks;
+        
+        // If the Blocks held are too few, move the Blocks to a larger heap allocation
+        if(block_count > capacity)
         {
-            // Define int to hold bits in letter
-            unsigned int bits_in_letter = 0;
+            // Allocate the new Blocks (Note: allocates)
+            size_t capacity = block_count;
+            Block *blocks = allocate_blocks(capacity);
+            
+            // Copy the used Blocks
+            std::memcpy(blocks, get_blocks(), old_block_count * sizeof(Block));
             
-            // Loop over bits in letter
-            for(unsigned int bit = 0; bit < g_bits_per_letter; ++bit)
-            {
-                // Flip apropos bit in bits_in_letter
-                if(m_relator[letter*g_bits_per_letter + bit])
-                    bits_in_letter |= (0x1 << bit);
-            }
+            // Free any old heap allocated Blocks
+            if(m_capacity)
+                free_blocks(m_heap_blocks, m_capacity);
             
-            // Append letter 
-            relator += Letters::get_letter(bits_in_letter);
+            // Use the new Blocks
+            m_heap_blocks = blocks;
+            m_capacity = capacity;
         }
         
-        // Return relator
-        return relator;
+        // Obtain the Blocks
+        Block *blocks = get_blocks();
+        
+        // Zero any newly used Blocks
+        for(size_t index = old_block_count; index < block_count; ++index)
+            blocks[index] = 0;
+        
+        // Obtain the number of bits used in the last Block
+        unsigned int used_bits = (length % g_letters_per_block) * g_bits_per_letter;
+        
+        // If the last Block is only partially used, zero the bits above the last letter
+        if(used_bits)
+            blocks[block_count - 1] &= (static_cast<Block>(0x1) << used_bits) - 1;
+        
+        // Set m_length
+        m_length = length;
     }
     
     inline Relator &Relator::operator=(const Relator &rhs)
@@ -100,12 +259,18 @@ namespace andrews_curtis
         if(this == &rhs)
             return *this;
         
-        // Copy dynamic_bitset
-        m_relator = rhs.m_relator;
+        // Drop the letters of this Relator (Note: does not allocate)
+        resize(0);
+        
+        // Make room for the letters of rhs (Note: may allocate)
+        resize(rhs.m_length);
+        
+        // Copy the letters of rhs
+        std::memcpy(get_blocks(), rhs.get_blocks(), get_block_count() * sizeof(Block));
         
-        // Do not copy position in tree
-        m_left = 0;
-        m_right = 0;
+        // Copy the hashes of rhs
+        m_hash = rhs.m_hash;
+        m_inverse_hash = rhs.m_inverse_hash;
         
         // Return self
         return *this;
@@ -113,9 +278,11 @@ namespace andrews_curtis
     
     inline bool Relator::operator==(const Relator &rhs) const
     {
-        if(m_relator.size() != rhs.m_relator.size())
+        if(m_length != rhs.m_length)
            return false;
-        return m_relator == rhs.m_relator;
+        if(m_hash != rhs.m_hash)
+           return false;
+        return !std::memcmp(get_blocks(), rhs.get_blocks(), get_block_count() * sizeof(Block));
     }
     
     inline bool Relator::operator!=(const Relator &rhs) const
@@ -125,11 +292,21 @@ namespace andrews_curtis
     
     inline bool Relator::operator<(const Relator &rhs) const
     {
-        if(m_relator.size() < rhs.m_relator.size())
+        if(m_length < rhs.m_length)
             return true;
-        if(m_relator.size() > rhs.m_relator.size())
+        if(m_length > rhs.m_length)
             return false;
-        return m_relator < rhs.m_relator;
+        
+        // Compare Blocks starting with the most significant, as the letters are
+        // stored least significant first this orders as dynamic_bitset did
+        const Block *blocks = get_blocks();
+        const Block *rhs_blocks = rhs.get_blocks();
+        for(size_t index = get_block_count(); index > 0; --index)
+        {
+            if(blocks[index - 1] != rhs_blocks[index - 1])
+                return blocks[index - 1] < rhs_blocks[index - 1];
+        }
+        return false;
     }
     
     inline bool Relator::operator<=(const Relator &rhs) const
@@ -150,42 +327,30 @@ namespace andrews_curtis
     template<class Archive>
     inline void Relator::save(Archive &archive,unsigned int version) const
     {
-        // Obtain size
-        boost::dynamic_bitset<>::size_type size = m_relator.size();;
-        
-        // Write size of m_relator to archive
-        archive & size;
-        
-        // Define a vetor to hold the blocks of m_relator
-        std::vector< boost::dynamic_bitset<>::block_type > blocks(m_relator.num_blocks());
+        // Write the number of letters to archive
+        archive & m_length;
         
-        // Write blocks to blocks
-        boost::to_block_range(m_relator,blocks.begin());
-        
-        // Write blocks to archive
-        archive & blocks;
+        // Write the Blocks to archive
+        archive & boost::serialization::make_array(const_cast<Block*>(get_blocks()), get_block_count());
     }
     
     template<class Archive>
     inline void Relator::load(Archive &archive,unsigned int version)
     {
-        // Define size
-        boost::dynamic_bitset<>::size_type size;
+        // Define the number of letters
+        unsigned int length;
         
-        // Read size from archive
-        archive & size;
-
-        // Resize m_relator (Note: may allocate)
-        m_relator.resize(size);
+        // Read the number of letters from archive
+        archive & length;
         
-        // Define vector to hold blocks
-        std::vector< boost::dynamic_bitset<>::block_type > blocks(m_relator.num_blocks());
+        // Make room for length letters (Note: may allocate)
+        resize(length);
         
-        // Read blocks from archive
-        archive & blocks;
+        // Read the Blocks from archive
+        archive & boost::serialization::make_array(get_blocks(), get_block_count());
         
-        // Copy blocks from blocks to m_relator
-        boost::from_block_range(blocks.begin(),blocks.end(),m_relator);
+        // Compute the hashes of the letters
+        rehash();
     }
 }
 
@@ -7,228 +7,821 @@
 //
 
 
+#include <algorithm>
+
 #include "globals.h"
 #include "relator.h"
+#include "relator_kernels.h"
+#include "slab_allocator.h"
 
 
 namespace andrews_curtis
-{    
+{
+    // Typedefs
+    typedef Relator::Block Block;
+    
+    // The modulus of Relator hashes, the Mersenne prime 2^61-1
+    static const boost::uint64_t s_modulus = (static_cast<boost::uint64_t>(0x1) << 61) - 1;
+    
+    // The base of Relator hashes
+    static const boost::uint64_t s_base = 0x16A09E667F3BCC9ULL;
+    
+    // Utility function that returns a*b modulo s_modulus
+    static boost::uint64_t multiply_modulo(boost::uint64_t a,boost::uint64_t b);
+    
+    // Utility function that returns a+b modulo s_modulus
+    static boost::uint64_t add_modulo(boost::uint64_t a,boost::uint64_t b);
+    
+    // Utility function that returns a-b modulo s_modulus
+    static boost::uint64_t subtract_modulo(boost::uint64_t a,boost::uint64_t b);
+    
+    // Utility function that returns base^exponent modulo s_modulus
+    static boost::uint64_t power_modulo(boost::uint64_t base,boost::uint64_t exponent);
+    
+    // The inverse of s_base modulo s_modulus (Note: Fermat's little theorem)
+    static const boost::uint64_t s_inverse_base = power_modulo(s_base, s_modulus - 2);
+    
+    // Utility function that shifts the passed Blocks by bits towards the first letter
+    static void shift_down(Block *blocks,size_t block_count,unsigned int bits);
+    
+    // Utility function that shifts the passed Blocks by bits away from the first letter
+    static void shift_up(Block *blocks,size_t block_count,unsigned int bits);
+    
+    // Utility function that ors bit_count bits from source, at source_bit, into destination, at destination_bit
+    static void copy_bits(Block *destination,size_t destination_count,size_t destination_bit,
+                          const Block *source,size_t source_count,size_t source_bit,size_t bit_count);
+    
+    // Utility function that overwrites bit_count bits of destination, at destination_bit, with those of source, at
+    // source_bit. As with memmove, the bits may overlap if destination and source are the same Blocks.
+    static void move_bits(Block *destination,size_t destination_count,size_t destination_bit,
+                          const Block *source,size_t source_count,size_t source_bit,size_t bit_count);
+    
+    // The number of Blocks of letters rotate() moves at a time, held on the stack
+    static const size_t s_rotation_blocks = 4;
+    
+    // The number of sizes of heap Blocks allocated from slabs, 2^2 to 2^(s_block_sizes+1) Blocks (Note: more use new[])
+    static const unsigned int s_block_sizes = 9;
+    
+    // Utility class holding the Slab_allocators of Relators and of heap Blocks
+    class Relator_allocators
+    {
+    public:
+        Relator_allocators()
+        :   m_relators(sizeof(Relator))
+        {
+            // Create the Slab_allocator of each size of heap Blocks
+            for(unsigned int index = 0; index < s_block_sizes; ++index)
+                m_blocks[index] = new Slab_allocator(sizeof(Block) << (index + 2));
+        }
+        
+        ~Relator_allocators()
+        {
+            // Delete the Slab_allocator of each size of heap Blocks
+            for(unsigned int index = 0; index < s_block_sizes; ++index)
+                delete m_blocks[index];
+        }
+        
+        /// The Slab_allocator of Relators
+        Slab_allocator m_relators;
+        
+        /// The Slab_allocators of heap Blocks, of 2^(index+2) Blocks at index
+        Slab_allocator *m_blocks[s_block_sizes];
+    };
+    
+    // Utility function that returns the Slab_allocators, constructed on first use
+    static Relator_allocators &get_allocators();
+    
+    
+    void *Relator::operator new(std::size_t /* size */)
+    {
+        // Note: size is that of every Relator, the size of the slab allocator's objects
+        return get_allocators().m_relators.allocate();
+    }
+    
+    void Relator::operator delete(void *relator)
+    {
+        get_allocators().m_relators.deallocate(relator);
+    }
+    
+    unsigned long Relator::get_allocations()
+    {
+        // Obtain the Slab_allocators
+        Relator_allocators &allocators = get_allocators();
+        
+        // Obtain the allocations of Relators
+        unsigned long allocations = allocators.m_relators.get_allocations();
+        
+        // Add the allocations of each size of heap Blocks
+        for(unsigned int index = 0; index < s_block_sizes; ++index)
+            allocations += allocators.m_blocks[index]->get_allocations();
+        
+        // Return the allocations
+        return allocations;
+    }
+    
+    void Relator::share()
+    {
+        // Obtain the Slab_allocators
+        Relator_allocators &allocators = get_allocators();
+        
+        // Share the freed Relators
+        allocators.m_relators.share();
+        
+        // Share the freed heap Blocks of each size
+        for(unsigned int index = 0; index < s_block_sizes; ++index)
+            allocators.m_blocks[index]->share();
+    }
+    
+    void Relator::release()
+    {
+        // Obtain the Slab_allocators
+        Relator_allocators &allocators = get_allocators();
+        
+        // Release the slabs of Relators
+        allocators.m_relators.release();
+        
+        // Release the slabs of each size of heap Blocks
+        for(unsigned int index = 0; index < s_block_sizes; ++index)
+            allocators.m_blocks[index]->release();
+    }
+    
+    Relator::Block *Relator::allocate_blocks(size_t &capacity)
+    {
+        // Find the least size of heap Blocks holding capacity Blocks
+        unsigned int index = 0;
+        while((index < s_block_sizes) && ((static_cast<size_t>(0x1) << (index + 2)) < capacity))
+            ++index;
+        
+        // If capacity is larger than all sizes, allocate exactly capacity Blocks (Note: allocates)
+        if(s_block_sizes == index)
+            return new Block[capacity];
+        
+        // Round capacity up to the size
+        capacity = static_cast<size_t>(0x1) << (index + 2);
+        
+        // Allocate the Blocks from the slabs of the size
+        return static_cast<Block*>(get_allocators().m_blocks[index]->allocate());
+    }
+    
+    void Relator::free_blocks(Block *blocks, size_t capacity)
+    {
+        // Find the size of heap Blocks holding capacity Blocks
+        unsigned int index = 0;
+        while((index < s_block_sizes) && ((static_cast<size_t>(0x1) << (index + 2)) < capacity))
+            ++index;
+        
+        // If capacity is larger than all sizes, the Blocks were allocated by new[]
+        if(s_block_sizes == index)
+            delete[] blocks;
+        else
+            get_allocators().m_blocks[index]->deallocate(blocks);
+    }
+    
     void Relator::invert()
     {
-        // TODO: Optimize this method to not require the copy below
+        // Obtain the number of Blocks
+        size_t block_count = get_block_count();
+        
+        // The empty Relator is its own inverse
+        if(!block_count)
+            return;
+        
+        // Obtain the Blocks
+        Block *blocks = get_blocks();
+        
+        // Swap the Blocks end for end, reversing and inverting their letters (Note: one's compliment)
+        Relator_kernels::reverse_invert(blocks, block_count, g_bits_per_letter);
+        
+        // The unused letters of the last Block now sit, inverted, below the first letter; shift them out
+        shift_down(blocks, block_count, (block_count*g_letters_per_block - m_length)*g_bits_per_letter);
+        
+        // The hash of the inverse is the hash of the inverse's inverse
+        std::swap(m_hash, m_inverse_hash);
+    }
+    
+    void Relator::rotate(size_t index)
+    {
+        // Rotating by a multiple of the length does nothing
+        if(!m_length || !(index % m_length))
+            return;
         
-        // Make a copy of m_relator
-        boost::dynamic_bitset<> source = m_relator;
+        // Reduce index modulo the length
+        index %= m_length;
         
-        // Obtain size of source
-        boost::dynamic_bitset<>::size_type size = source.size();
+        // Define the Blocks holding the letters moved from the start to the end (Note: on the stack)
+        Block buffer[s_rotation_blocks] = {0};
         
-        // Obain count of letters in source
-        unsigned long letter_count = size / g_bits_per_letter;
+        // Obtain the Blocks
+        Block *blocks = get_blocks();
+        size_t block_count = get_block_count();
         
-        // Loop over "half" the leters in source
-        for(unsigned int letter = 0; letter < (letter_count/2); ++letter)
+        // Rotate by at most the letters buffer holds at a time, in place
+        while(index)
         {
-            // Loop over the bits in letter
-            for(unsigned int bit = 0; bit < g_bits_per_letter; ++bit)
-            {
-                // Write the inversion of the apropos bits (Note: Letters as in one's compliment)
-                m_relator[size - letter*g_bits_per_letter - g_bits_per_letter + bit] = 
-                    !source[letter*g_bits_per_letter + bit];
-                m_relator[letter*g_bits_per_letter + bit] = 
-                    !source[size - letter*g_bits_per_letter - g_bits_per_letter + bit];
-            }
+            // Obtain the number of letters to move from the start to the end
+            size_t count = std::min<size_t>(index, s_rotation_blocks*g_letters_per_block);
+            
+            // Save the letters before count
+            move_bits(buffer, s_rotation_blocks, 0, blocks, block_count, 0, count*g_bits_per_letter);
+            
+            // Move the letters from count on to the start
+            move_bits(blocks, block_count, 0, blocks, block_count, count*g_bits_per_letter, (m_length - count)*g_bits_per_letter);
+            
+            // Put the saved letters at the end
+            move_bits(blocks, block_count, (m_length - count)*g_bits_per_letter, buffer, s_rotation_blocks, 0, count*g_bits_per_letter);
+            
+            // Count the letters rotated
+            index -= count;
         }
         
-        // If there is a middle element in m_relator
-        if(1 == (letter_count % 2))
+        // Compute the hashes of the rotated letters
+        rehash();
+    }
+    
+    void Relator::make_cyclic()
+    {
+        // Obtain the mask inverting a letter
+        unsigned int mask = (0x1 << g_bits_per_letter) - 1;
+        
+        // Define the number of letters cancelling from each end
+        size_t reduction = 0;
+        
+        // Count the letters at the start that are inverses of the letters at the end
+        while(((2*reduction + 2) <= m_length) && (get_letter(reduction) == (get_letter(m_length - reduction - 1) ^ mask)))
+            ++reduction;
+        
+        // If letters cancel, drop them from both ends
+        if(reduction)
         {
-            // Loop over the bits in middle letter
-            for(unsigned int bit = 0; bit < g_bits_per_letter; ++bit)
+            // Move the letters between the cancelled letters to the start, in place
+            move_bits(get_blocks(), get_block_count(), 0,
+                      get_blocks(), get_block_count(), reduction*g_bits_per_letter,
+                      (m_length - 2*reduction)*g_bits_per_letter);
+            
+            // Drop the letters after them (Note: does not allocate)
+            resize(m_length - 2*reduction);
+            
+            // Compute the hashes of the remaining letters
+            rehash();
+        }
+        
+        // Define the two candidate least rotations and the length of their common prefix
+        size_t first = 0;
+        size_t second = 1;
+        size_t common = 0;
+        
+        // Find the least rotation in linear time, dropping candidates that can't be least
+        while((first < m_length) && (second < m_length) && (common < m_length))
+        {
+            // Obtain the letters following the common prefix of the two candidates
+            unsigned int first_letter = get_letter((first + common) % m_length);
+            unsigned int second_letter = get_letter((second + common) % m_length);
+            
+            // If the letters agree, extend the common prefix
+            if(first_letter == second_letter)
             {
-                // Invert the middle element in source
-                m_relator[(letter_count/2)*g_bits_per_letter + bit] =  
-                    !source[(letter_count/2)*g_bits_per_letter + bit];
+                ++common;
+                continue;
             }
+            
+            // Drop the greater candidate and all rotations starting within its common prefix
+            if(first_letter > second_letter)
+                first += common + 1;
+            else
+                second += common + 1;
+            
+            // The candidates must differ
+            if(first == second)
+                ++second;
+            
+            // Restart the common prefix
+            common = 0;
         }
+        
+        // Rotate to the least rotation
+        rotate((first < second) ? first : second);
     }
     
-    void Relator::conjugate(int generator)
+    void Relator::relabel(const unsigned int *letters)
     {
-        // TODO: Optimize this method to not require the copy below
+        // Dispatch to the letter width
+        if(4 == g_bits_per_letter)
+            relabel_letters<4>(letters);
+        else
+            relabel_letters<8>(letters);
+    }
+    
+    template <unsigned int Bits>
+    void Relator::relabel_letters(const unsigned int *letters)
+    {
+        // Obtain the mask of a letter
+        const Block mask = (static_cast<Block>(0x1) << Bits) - 1;
+        
+        // Obtain the blocks of this Relator
+        Block *blocks = get_blocks();
+        
+        // Loop over blocks
+        for(size_t block = 0; block < get_block_count(); ++block)
+        {
+            // Define the relabeled block
+            Block relabeled = 0;
+            
+            // Relabel the letters of the block (Note: padding letters are 0 and stay 0)
+            for(unsigned int shift = 0; shift < s_bits_per_block; shift += Bits)
+                relabeled |= static_cast<Block>(letters[(blocks[block] >> shift) & mask]) << shift;
+            
+            // Store the relabeled block
+            blocks[block] = relabeled;
+        }
+        
+        // Compute the hashes of the relabeled letters
+        rehash<Bits>();
+    }
+    
+    void Relator::rehash()
+    {
+        // Dispatch to the letter width
+        if(4 == g_bits_per_letter)
+            rehash<4>();
+        else
+            rehash<8>();
+    }
+    
+    template <unsigned int Bits>
+    void Relator::rehash()
+    {
+        // Reset the hashes
+        m_hash = 0;
+        m_inverse_hash = 0;
+        
+        // Define the power of s_base for the current letter
+        boost::uint64_t power = 1;
         
-        // Make a copy of m_relator
-        boost::dynamic_bitset<> source = m_relator;
+        // Obtain the mask inverting a letter
+        const unsigned int mask = (0x1 << Bits) - 1;
         
-        // Obtain source length
-        boost::dynamic_bitset<>::size_type relator_length = source.size();
+        // Loop over letters
+        for(size_t index = 0; index < m_length; ++index)
+        {
+            // Obtain the letter at index
+            unsigned int letter = get_letter<Bits>(index);
+            
+            // Add letter*B^index to m_hash
+            m_hash = add_modulo(m_hash, multiply_modulo(letter, power));
+            
+            // Add the inverse of letter at index, the inverse's letter m_length-index-1, with Horner's rule
+            m_inverse_hash = add_modulo(multiply_modulo(m_inverse_hash, s_base), letter ^ mask);
+            
+            // Obtain the power of s_base for the next letter
+            power = multiply_modulo(power, s_base);
+        }
+    }
+    
+    boost::uint64_t Relator::get_conjugate_hash(int generator) const
+    {
+        // Define the hashes of the conjugate
+        boost::uint64_t hash, inverse_hash;
         
-        // Obtain new relator length, assuming no cancellations
-        boost::dynamic_bitset<>::size_type length = relator_length + (2*g_bits_per_letter);
+        // Obtain the hashes of the conjugate
+        get_conjugate_hashes(generator, hash, inverse_hash);
         
-        // Define where to start copying bits from source to this m_relator
-        boost::dynamic_bitset<>::size_type loop_start = 0;
+        // Return the hash of the conjugate
+        return hash;
+    }
+    
+    boost::uint64_t Relator::get_product_hash(const Relator *relator2) const
+    {
+        // Count the cancelations in this*relator2
+        size_t cancelation_count = Relator_kernels::cancellation_length(get_blocks(), m_length,
+                                                                        relator2->get_blocks(), relator2->m_length,
+                                                                        g_bits_per_letter);
+        
+        // Define the hashes of the product
+        boost::uint64_t hash, inverse_hash;
         
-        // Define where to stop copying bits from source to this m_relator
-        boost::dynamic_bitset<>::size_type loop_stop = relator_length;
+        // Obtain the hashes of the product
+        get_product_hashes(relator2, cancelation_count, hash, inverse_hash);
         
-        // Obtain bool array representing the letter 'generator'
-        const bool *letter = Letters::get_bools(generator);
+        // Return the hash of the product
+        return hash;
+    }
+    
+    void Relator::get_conjugate_hashes(int generator, boost::uint64_t &hash, boost::uint64_t &inverse_hash) const
+    {
+        // Obtain bits representing the letter 'generator'
+        unsigned int letter = Letters::get_generator_bits(generator);
         
-        // Define a bool to indicate if an initial cancellation occurs
-        bool initial_cancellation = !relator_length ? false : true;
+        // Obtain bits representing the inverse of the letter 'generator' (Note: one's compliment)
+        unsigned int inverse = Letters::get_inverse(letter);
         
-        // Loop over initial bits to look for a cancellation
-        for(unsigned int bit = 0; initial_cancellation && (bit < g_bits_per_letter); ++bit)
+        // Determine if an initial cancellation occurs
+        bool initial_cancellation = m_length && (get_letter(0) == inverse);
+        
+        // Determine if a final cancellation occurs
+        bool final_cancellation = m_length && (get_letter(m_length - 1) == letter);
+        
+        // If there are both an initial and a final cancellation, r = g^-1*u*g => u
+        if(initial_cancellation && final_cancellation)
         {
-            // Check for cancellation (Remember, one's compliment and -N is the inverse of N)
-            if(letter[bit] == source[bit])
-                initial_cancellation = false;
+            // Obtain B^(length-1)
+            boost::uint64_t power = power_modulo(s_base, m_length - 1);
+            
+            // The hash of r => u, and of r^-1 = g^-1*u^-1*g => u^-1
+            hash = multiply_modulo(subtract_modulo(subtract_modulo(m_hash, inverse), multiply_modulo(letter, power)), s_inverse_base);
+            inverse_hash = multiply_modulo(subtract_modulo(subtract_modulo(m_inverse_hash, inverse), multiply_modulo(letter, power)), s_inverse_base);
         }
-        
-        // If there is an initial cancellation, adjust length and loop_start
-        if(initial_cancellation)
+        // If there is only an initial cancellation, r = g^-1*u => u*g^-1
+        else if(initial_cancellation)
         {
-            // Modify length
-            length -= (2*g_bits_per_letter);
+            // Obtain B^(length-1)
+            boost::uint64_t power = power_modulo(s_base, m_length - 1);
             
-            // Set loop_start
-            loop_start += g_bits_per_letter;
+            // The hash of r => u*g^-1
+            hash = add_modulo(multiply_modulo(subtract_modulo(m_hash, inverse), s_inverse_base), multiply_modulo(inverse, power));
+            
+            // The hash of r^-1 = u^-1*g => g*u^-1
+            inverse_hash = add_modulo(letter, multiply_modulo(subtract_modulo(m_inverse_hash, multiply_modulo(letter, power)), s_base));
         }
-        
-        // Define a bool to indicate if a final cancellation occurs
-        bool final_cancellation = !relator_length ? false : true;
-        
-        // Loop over final bits to look for a cancellation
-        for(unsigned int bit = 0; final_cancellation && (bit < g_bits_per_letter); ++bit)
+        // If there is only a final cancellation, r = u*g => g*u
+        else if(final_cancellation)
         {
-            // Check for cancellation
-            if(letter[bit] != source[relator_length - g_bits_per_letter + bit])
-                final_cancellation = false;
+            // Obtain B^(length-1)
+            boost::uint64_t power = power_modulo(s_base, m_length - 1);
+            
+            // The hash of r => g*u
+            hash = add_modulo(letter, multiply_modulo(subtract_modulo(m_hash, multiply_modulo(letter, power)), s_base));
+            
+            // The hash of r^-1 = g^-1*u^-1 => u^-1*g^-1
+            inverse_hash = add_modulo(multiply_modulo(subtract_modulo(m_inverse_hash, inverse), s_inverse_base), multiply_modulo(inverse, power));
         }
-        
-        // If there is an final cancellation, adjust length and loop_stop
-        if(final_cancellation)
+        // If there are no cancellations, r => g*r*g^-1
+        else
         {
-            // Modify length
-            length -= (2*g_bits_per_letter);
+            // Obtain B^(length+1)
+            boost::uint64_t power = power_modulo(s_base, m_length + 1);
             
-            // Set loop_stop
-            loop_stop -= g_bits_per_letter;
+            // The hash of r => g*r*g^-1, and of r^-1 => g*r^-1*g^-1
+            hash = add_modulo(add_modulo(letter, multiply_modulo(m_hash, s_base)), multiply_modulo(inverse, power));
+            inverse_hash = add_modulo(add_modulo(letter, multiply_modulo(m_inverse_hash, s_base)), multiply_modulo(inverse, power));
         }
+    }
+    
+    void Relator::get_product_hashes(const Relator *relator2, size_t cancelation_count, boost::uint64_t &hash, boost::uint64_t &inverse_hash) const
+    {
+        // Obtain relator1 length
+        size_t relator1_length = m_length;
+        
+        // Obtain relator2 length
+        size_t relator2_length = relator2->m_length;
         
-        // Resize m_relator to hold length bits. (Note: may allocate)
-        m_relator.resize(length);
+        // Define the hash of the cancelled letters of relator2, t^-1 where relator1 = r*t and relator2 = t^-1*s
+        boost::uint64_t head_hash = 0;
         
-        // Define number of bits to skip when copying source to m_relator
-        int bits_to_skip = -g_bits_per_letter;
+        // Define the hash of the cancelled letters of relator1, t
+        boost::uint64_t tail_hash = 0;
         
-        // If there's no starting cancelation
-        if(0 == loop_start)
+        // Define the power of s_base for the current letter
+        boost::uint64_t power = 1;
+        
+        // Obtain the mask inverting a letter
+        unsigned int mask = (0x1 << g_bits_per_letter) - 1;
+        
+        // Loop over the cancelled letters of relator2
+        for(size_t index = 0; index < cancelation_count; ++index)
         {
-            // Add the first letter
-            for(unsigned int bit = 0; bit < g_bits_per_letter; ++bit)
-                m_relator[bit] = letter[bit];
+            // Add letter*B^index to head_hash
+            head_hash = add_modulo(head_hash, multiply_modulo(relator2->get_letter(index), power));
             
-            // Set bits_to_skip to skip this data
-            bits_to_skip = g_bits_per_letter;
+            // Add the inverse of the letter, letter cancelation_count-index-1 of t, with Horner's rule
+            tail_hash = add_modulo(multiply_modulo(tail_hash, s_base), relator2->get_letter(index) ^ mask);
+            
+            // Obtain the power of s_base for the next letter
+            power = multiply_modulo(power, s_base);
         }
         
-        // Loop over non-canceled characters of source
-        for(boost::dynamic_bitset<>::size_type index = loop_start; index < loop_stop; ++index)
+        // Obtain B^-cancelation_count
+        boost::uint64_t inverse_power = power_modulo(s_inverse_base, cancelation_count);
+        
+        // Obtain the hash of r = relator1 less t, and of r^-1 where relator1^-1 = t^-1*r^-1
+        boost::uint64_t r_hash = subtract_modulo(m_hash, multiply_modulo(tail_hash, power_modulo(s_base, relator1_length - cancelation_count)));
+        boost::uint64_t r_inverse_hash = multiply_modulo(subtract_modulo(m_inverse_hash, head_hash), inverse_power);
+        
+        // Obtain the hash of s = relator2 less t^-1, and of s^-1 where relator2^-1 = s^-1*t
+        boost::uint64_t s_hash = multiply_modulo(subtract_modulo(relator2->m_hash, head_hash), inverse_power);
+        boost::uint64_t s_inverse_hash = subtract_modulo(relator2->m_inverse_hash, multiply_modulo(tail_hash, power_modulo(s_base, relator2_length - cancelation_count)));
+        
+        // The hash of r*s, and of s^-1*r^-1
+        hash = add_modulo(r_hash, multiply_modulo(s_hash, power_modulo(s_base, relator1_length - cancelation_count)));
+        inverse_hash = add_modulo(s_inverse_hash, multiply_modulo(r_inverse_hash, power_modulo(s_base, relator2_length - cancelation_count)));
+    }
+    
+    void Relator::conjugate(int generator)
+    {
+        // Obtain the hashes of the conjugate, from the letters before the move
+        boost::uint64_t hash, inverse_hash;
+        get_conjugate_hashes(generator, hash, inverse_hash);
+        
+        // Obtain bits representing the letter 'generator'
+        unsigned int letter = Letters::get_generator_bits(generator);
+        
+        // Obtain bits representing the inverse of the letter 'generator' (Note: one's compliment)
+        unsigned int inverse = Letters::get_inverse(letter);
+        
+        // Determine if an initial cancellation occurs
+        bool initial_cancellation = m_length && (get_letter(0) == inverse);
+        
+        // Determine if a final cancellation occurs
+        bool final_cancellation = m_length && (get_letter(m_length - 1) == letter);
+        
+        // If there are both an initial and a final cancellation, r = g^-1*u*g => u
+        if(initial_cancellation && final_cancellation)
         {
-            // Add the index bit to m_relator
-            m_relator[index + bits_to_skip] = source[index];
+            // Drop the first letter
+            shift_down(get_blocks(), get_block_count(), g_bits_per_letter);
+            
+            // Drop the last letter
+            resize(m_length - 2);
         }
-        
-        // If there's no stoping cancelation
-        if(relator_length == loop_stop)
+        // If there is only an initial cancellation, r = g^-1*u => u*g^-1
+        else if(initial_cancellation)
+        {
+            // Drop the first letter
+            shift_down(get_blocks(), get_block_count(), g_bits_per_letter);
+            
+            // Append the inverse of the generator in the freed last letter
+            set_letter(m_length - 1, inverse);
+        }
+        // If there is only a final cancellation, r = u*g => g*u
+        else if(final_cancellation)
         {
-            // Add the final letter
-            for(unsigned int bit = 0; bit < g_bits_per_letter; ++bit)
-                m_relator[length - g_bits_per_letter + bit] = !letter[bit];
+            // Drop the last letter, then make room for the generator (Note: does not allocate)
+            resize(m_length - 1);
+            resize(m_length + 1);
+            
+            // Make room for the generator at the start
+            shift_up(get_blocks(), get_block_count(), g_bits_per_letter);
+            
+            // Prepend the generator
+            set_letter(0, letter);
         }
+        // If there are no cancellations, r => g*r*g^-1
+        else
+        {
+            // Make room for two more letters (Note: may allocate)
+            resize(m_length + 2);
+            
+            // Make room for the generator at the start
+            shift_up(get_blocks(), get_block_count(), g_bits_per_letter);
+            
+            // Prepend the generator
+            set_letter(0, letter);
+            
+            // Append the inverse of the generator
+            set_letter(m_length - 1, inverse);
+        }
+        
+        // Set the hashes of the conjugate
+        m_hash = hash;
+        m_inverse_hash = inverse_hash;
     }
     
-    void Relator::multiply(const Relator *relator2)
+    bool Relator::write(std::FILE *file) const
+    {
+        // Write the number of letters, then the Blocks
+        return (std::fwrite(&m_length, sizeof(m_length), 1, file) == 1) && (std::fwrite(get_blocks(), sizeof(Block), get_block_count(), file) == get_block_count());
+    }
+    
+    bool Relator::read(std::FILE *file)
     {
-        // TODO: Optimize this method to not require the copy below
+        // Read the number of letters, if there is a Relator left
+        unsigned int length;
+        if(std::fread(&length, sizeof(length), 1, file) != 1)
+            return false;
+        
+        // Make room for length letters (Note: may allocate)
+        resize(length);
+        
+        // Read the Blocks
+        if(std::fread(get_blocks(), sizeof(Block), get_block_count(), file) != get_block_count())
+            return false;
         
-        // Make a copy of m_relator
-        boost::dynamic_bitset<> source = m_relator;
+        // Compute the hashes of the letters
+        rehash();
+        
+        // Indicate a Relator was read
+        return true;
+    }
+    
+    void Relator::multiply(const Relator *relator2)
+    {
+        // If multiplying by ourself, the letters of relator2 are changed below; so, move them in place
+        if(this == relator2)
+        {
+            // Obtain the length
+            size_t length = m_length;
+            
+            // Count the cancelations in r*r
+            size_t cancelation_count = Relator_kernels::cancellation_length(get_blocks(), length,
+                                                                            get_blocks(), length,
+                                                                            g_bits_per_letter);
+            
+            // Set the hashes of the product, from the letters before the move
+            get_product_hashes(this, cancelation_count, m_hash, m_inverse_hash);
+            
+            // Make room for the product, if it is longer (Note: may allocate)
+            resize(std::max(length, 2*(length - cancelation_count)));
+            
+            // Move the non-cancelled letters of the right factor after those of the left factor
+            move_bits(get_blocks(), get_block_count(), (length - cancelation_count)*g_bits_per_letter,
+                      get_blocks(), get_block_count(), cancelation_count*g_bits_per_letter,
+                      (length - cancelation_count)*g_bits_per_letter);
+            
+            // Drop any letters after the product (Note: does not allocate)
+            resize(2*(length - cancelation_count));
+            
+            // Return to caller
+            return;
+        }
         
         // Obtain relator1 length
-        boost::dynamic_bitset<>::size_type relator1_length = source.size();
+        size_t relator1_length = m_length;
         
         // Obtain relator2 length
-        boost::dynamic_bitset<>::size_type relator2_length = relator2->m_relator.size();
+        size_t relator2_length = relator2->m_length;
         
-        // Obtain navie length assuming no cancelations
-        boost::dynamic_bitset<>::size_type naive_length = relator1_length + relator2_length;
+        // Count the cancelations in relator1*relator2
+        size_t cancelation_count = Relator_kernels::cancellation_length(get_blocks(), relator1_length,
+                                                                        relator2->get_blocks(), relator2_length,
+                                                                        g_bits_per_letter);
         
-        // Determine min of relator1_length and relator2_length
-        boost::dynamic_bitset<>::size_type min_length = 
-        (relator1_length < relator2_length) ? relator1_length : relator2_length;
+        // Set the hashes of the product, from the letters before the move
+        get_product_hashes(relator2, cancelation_count, m_hash, m_inverse_hash);
         
-        // Define cancelation_count to count the cancelations in relator1*relator2
-        unsigned int cancelation_count = 0;
+        // Drop the cancelled elements from relator1
+        resize(relator1_length - cancelation_count);
         
-        // Declare bool used to indicate if a cancelations occurs
-        bool is_cancelation;
+        // Resize to hold the non-cancelled elements of relator2. (Note: may allocate)
+        resize(relator1_length + relator2_length - 2*cancelation_count);
+        
+        // Copy the non-canceled elements from relator2
+        if(relator2_length > cancelation_count)
+            copy_bits(get_blocks(), get_block_count(), (relator1_length - cancelation_count)*g_bits_per_letter,
+                      relator2->get_blocks(), relator2->get_block_count(), cancelation_count*g_bits_per_letter,
+                      (relator2_length - cancelation_count)*g_bits_per_letter);
+    }
+    
+    void shift_down(Block *blocks,size_t block_count,unsigned int bits)
+    {
+        // If there is nothing to shift, return
+        if(!bits)
+            return;
         
-        // Declare bool's used to hold relator1 and relator2 bits
-        bool relator1_bit;
-        bool relator2_bit;
+        // Loop over Blocks, pulling in the low bits of the following Block
+        for(size_t index = 0; (index + 1) < block_count; ++index)
+            blocks[index] = (blocks[index] >> bits) | (blocks[index + 1] << (Relator::s_bits_per_block - bits));
         
-        // Determine actual new length based on calcelations
-        for(unsigned int letter = 0; letter < (min_length / g_bits_per_letter); ++letter)
+        // Shift the last Block, shifting in zeros
+        if(block_count)
+            blocks[block_count - 1] >>= bits;
+    }
+    
+    void shift_up(Block *blocks,size_t block_count,unsigned int bits)
+    {
+        // If there is nothing to shift, return
+        if(!bits)
+            return;
+        
+        // Loop over Blocks from the last, pulling in the high bits of the preceding Block
+        for(size_t index = block_count; index > 1; --index)
+            blocks[index - 1] = (blocks[index - 1] << bits) | (blocks[index - 2] >> (Relator::s_bits_per_block - bits));
+        
+        // Shift the first Block, shifting in zeros
+        if(block_count)
+            blocks[0] <<= bits;
+    }
+    
+    void copy_bits(Block *destination,size_t destination_count,size_t destination_bit,
+                   const Block *source,size_t source_count,size_t source_bit,size_t bit_count)
+    {
+        // Loop over the bits to copy a Block at a time
+        for(size_t copied = 0; copied < bit_count; copied += Relator::s_bits_per_block)
         {
-            // Re-set is_cancelation
-            is_cancelation = true;
+            // Obtain the next Block of source bits
+            Block block = Relator_kernels::read_block(source, source_count, source_bit + copied);
             
-            // Loop over bits
-            for(unsigned int bit = 0; is_cancelation && (bit < g_bits_per_letter); ++bit)
-            {
-                // Obtain current relator1 bit
-                relator1_bit = source[relator1_length - g_bits_per_letter - letter*g_bits_per_letter + bit];
-                
-                // Obtain current relator2 bit
-                relator2_bit = relator2->m_relator[letter*g_bits_per_letter + bit];
-                
-                // Check current bit for lack of cancelation
-                if(relator1_bit == relator2_bit)
-                    is_cancelation = false;
-            }
+            // Mask off any bits beyond bit_count
+            if((bit_count - copied) < Relator::s_bits_per_block)
+                block &= (static_cast<Block>(0x1) << (bit_count - copied)) - 1;
             
-            // Check is_cancelation
-            if(is_cancelation)
-            {
-                // Increment cancelation_count
-                cancelation_count += 1;
-            }
-            else
-            {
-                // Break out of the loop, non-concident cancelations can't occur
-                break;
-            }
+            // Obtain the index of the destination Block
+            size_t index = (destination_bit + copied) / Relator::s_bits_per_block;
+            
+            // Obtain the offset in the destination Block
+            unsigned int offset = (destination_bit + copied) % Relator::s_bits_per_block;
+            
+            // Or the low bits of block into the destination Block
+            destination[index] |= block << offset;
+            
+            // Or the high bits of block into the following destination Block
+            if(offset && ((index + 1) < destination_count))
+                destination[index + 1] |= block >> (Relator::s_bits_per_block - offset);
         }
+    }
+    
+    void move_bits(Block *destination,size_t destination_count,size_t destination_bit,
+                   const Block *source,size_t source_count,size_t source_bit,size_t bit_count)
+    {
+        // Obtain the number of Blocks of bits to move
+        size_t chunk_count = (bit_count + Relator::s_bits_per_block - 1) / Relator::s_bits_per_block;
         
-        // Resize m_relator to hold the actual number of bits. (Note: may allocate)
-        m_relator.resize(naive_length - (2*cancelation_count*g_bits_per_letter));
+        // If the bits move up within the same Blocks, move the last Block of bits first, so no bit is
+        // overwritten before it is read (Note: moving down, the first Block of bits is moved first)
+        bool is_backward = (destination == source) && (destination_bit > source_bit);
         
-        // Copy the non-canceled elements from relator1
-        for(boost::dynamic_bitset<>::size_type index = 0; index < (relator1_length - cancelation_count*g_bits_per_letter); ++index)
+        // Loop over the bits to move a Block at a time
+        for(size_t chunk = 0; chunk < chunk_count; ++chunk)
         {
-            // Copy the element at index
-            m_relator[index] = source[index];
+            // Obtain the offset of the Block of bits to move
+            size_t moved = (is_backward ? (chunk_count - chunk - 1) : chunk) * Relator::s_bits_per_block;
+            
+            // Obtain the number of bits in the Block of bits to move
+            unsigned int width = std::min<size_t>(bit_count - moved, Relator::s_bits_per_block);
+            
+            // Obtain the mask of the bits to move
+            Block mask = (width < Relator::s_bits_per_block) ? ((static_cast<Block>(0x1) << width) - 1) : ~static_cast<Block>(0);
+            
+            // Obtain the Block of bits to move
+            Block block = Relator_kernels::read_block(source, source_count, source_bit + moved) & mask;
+            
+            // Obtain the index of the destination Block
+            size_t index = (destination_bit + moved) / Relator::s_bits_per_block;
+            
+            // Obtain the offset in the destination Block
+            unsigned int offset = (destination_bit + moved) % Relator::s_bits_per_block;
+            
+            // Overwrite the low bits of block into the destination Block
+            destination[index] = (destination[index] & ~(mask << offset)) | (block << offset);
+            
+            // Overwrite the high bits of block into the following destination Block
+            if(offset && ((offset + width) > Relator::s_bits_per_block) && ((index + 1) < destination_count))
+            {
+                // Obtain the number of bits in the following destination Block
+                unsigned int shift = Relator::s_bits_per_block - offset;
+                
+                // Overwrite them
+                destination[index + 1] = (destination[index + 1] & ~(mask >> shift)) | (block >> shift);
+            }
         }
+    }
+    
+    Relator_allocators &get_allocators()
+    {
+        // Construct the Slab_allocators on first use (Note: thread safe)
+        static Relator_allocators allocators;
         
-        // Copy the non-canceled elements from relator2
-        for(boost::dynamic_bitset<>::size_type index = cancelation_count*g_bits_per_letter; index < relator2_length; ++index)
+        // Return the Slab_allocators
+        return allocators;
+    }
+    
+    boost::uint64_t multiply_modulo(boost::uint64_t a,boost::uint64_t b)
+    {
+        // Obtain the full product
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        
+        // Fold the high bits onto the low bits, 2^61 = 1 modulo s_modulus
+        boost::uint64_t result = (static_cast<boost::uint64_t>(product) & s_modulus) + static_cast<boost::uint64_t>(product >> 61);
+        
+        // Fold once more and reduce
+        result = (result & s_modulus) + (result >> 61);
+        return (result >= s_modulus) ? (result - s_modulus) : result;
+    }
+    
+    boost::uint64_t add_modulo(boost::uint64_t a,boost::uint64_t b)
+    {
+        boost::uint64_t result = a + b;
+        return (result >= s_modulus) ? (result - s_modulus) : result;
+    }
+    
+    boost::uint64_t subtract_modulo(boost::uint64_t a,boost::uint64_t b)
+    {
+        return (a >= b) ? (a - b) : (a + s_modulus - b);
+    }
+    
+    boost::uint64_t power_modulo(boost::uint64_t base,boost::uint64_t exponent)
+    {
+        // Define the result
+        boost::uint64_t result = 1;
+        
+        // Square and multiply
+        while(exponent)
         {
-            // Copy the element at index
-            m_relator[(relator1_length - cancelation_count*g_bits_per_letter) + (index - cancelation_count*g_bits_per_letter)] =
-            relator2->m_relator[index];
+            if(exponent & 0x1)
+                result = multiply_modulo(result, base);
+            base = multiply_modulo(base, base);
+            exponent >>= 1;
         }
+        
+        // Return the result
+        return result;
     }
 }
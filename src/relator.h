@@ -10,18 +10,16 @@
 #define Andrews_Curtis_Conjecture_relator_h
 
 
+#include <cstdio>
 #include <string>
 
-#include <boost/dynamic_bitset.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/split_member.hpp>
 
 
 namespace andrews_curtis
 {
-    /// Forward declaration
-    template <class T> class Binary_tree;
-    
     /// 
     /// An instance of this class representes a relator.  A relator is a word
     /// in the generators and their inverses.
@@ -29,6 +27,15 @@ namespace andrews_curtis
     class Relator
     {
     public:
+        /// The machine word in which letters are packed
+        typedef boost::uint64_t Block;
+        
+        /// The number of bits in a Block
+        static const unsigned int s_bits_per_block = 64;
+        
+        /// The number of Blocks stored in the Relator itself
+        static const unsigned int s_inline_blocks = 3;
+        
         //
         // Default construct this Relator, with an empy word.
         //
@@ -42,6 +49,55 @@ namespace andrews_curtis
         //
         Relator(const char *relator);
         
+        //
+        // Copy construct this Relator from the passed Relator. The copy is not
+        // in the Relator_table.
+        //
+        // \param relator The Relator to copy
+        //
+        Relator(const Relator &relator);
+        
+        //
+        // Destructor
+        //
+        ~Relator();
+        
+        //
+        // Allocates a Relator from the slabs of Relators, see Slab_allocator
+        //
+        // \param size The size of a Relator
+        // \return The allocated Relator
+        //
+        static void *operator new(std::size_t size);
+        
+        //
+        // Frees a Relator to the slabs of Relators, see Slab_allocator
+        //
+        // \param relator The Relator to free
+        //
+        static void operator delete(void *relator);
+        
+        ///
+        /// Obtains the number of Relators, and of heap Blocks of Relators,
+        /// allocated from slabs by all threads
+        ///
+        /// \return The number of allocations
+        ///
+        static unsigned long get_allocations();
+        
+        ///
+        /// Shares the heap Relators, and heap Blocks of Relators, freed by the
+        /// calling thread with all threads, see Slab_allocator::share()
+        ///
+        static void share();
+        
+        ///
+        /// Returns the slabs of Relators, and of heap Blocks of Relators, to the
+        /// system at once. No heap Relator, or Relator with heap Blocks, may be
+        /// in use and no thread may be allocating.
+        ///
+        static void release();
+        
         ///
         /// Inverts the Relator in place
         ///
@@ -63,6 +119,72 @@ namespace andrews_curtis
         ///
         void multiply(const Relator *relator);
         
+        ///
+        /// Rotates the Relator in place, so the letter at the passed index becomes
+        /// the first letter. This conjugates the Relator by the letters before the
+        /// passed index.
+        ///
+        /// \param index The index of the letter to become the first letter
+        ///
+        void rotate(size_t index);
+        
+        ///
+        /// Cyclically reduces the Relator in place, then rotates it to its least
+        /// rotation, i.e. the rotation whose letters are lexicographically least.
+        /// Relators that are cyclic permutations of each other, once cyclically
+        /// reduced, are so made equal.
+        ///
+        void make_cyclic();
+        
+        ///
+        /// Relabels the letters of the Relator in place. The letter with bits
+        /// i is replaced by the letter with bits letters[i], so letters must
+        /// have 2^g_bits_per_letter entries and map 0 to 0.
+        ///
+        /// \param letters The table of relabeled letters
+        ///
+        void relabel(const unsigned int *letters);
+        
+        ///
+        /// Returns the hash the Relator would have after conjugate(generator),
+        /// without changing the Relator. This needs only the Relator's first
+        /// and last letters and its cached hashes.
+        ///
+        /// \param generator The generator to conjugate by
+        /// \return The hash of the conjugate
+        ///
+        boost::uint64_t get_conjugate_hash(int generator) const;
+        
+        ///
+        /// Returns the hash the Relator would have after multiply(relator),
+        /// without changing the Relator. This needs only the cancelled letters
+        /// and the cached hashes of the two Relators.
+        ///
+        /// \param relator The Relator to multiply on the right with
+        /// \return The hash of the product
+        ///
+        boost::uint64_t get_product_hash(const Relator *relator) const;
+        
+        ///
+        /// Returns the hash of the inverse of the Relator, i.e. the hash the
+        /// Relator would have after invert()
+        ///
+        /// \return The hash of the inverse
+        ///
+        boost::uint64_t get_inverse_hash() const;
+        
+        ///
+        /// Mixes the letters of the Relator into the passed 128 bit fingerprint,
+        /// so the Relators of a presentation, mixed in turn into the fingerprint
+        /// 0, fingerprint it. Unlike its Relator_table id, the fingerprint of a
+        /// Relator depends only on its letters, so is the same on every process
+        /// and outlives Relator_table::clear().
+        ///
+        /// \param high The high 64 bits of the fingerprint
+        /// \param low The low 64 bits of the fingerprint
+        ///
+        void add_to_fingerprint(boost::uint64_t &high, boost::uint64_t &low) const;
+        
         ///
         /// Returns the length of the relator
         ///
@@ -70,8 +192,16 @@ namespace andrews_curtis
         ///
         size_t get_length() const;
         
+        ///
+        /// Returns the number of bytes of the relator, itself and any heap Blocks
+        ///
+        /// \return The number of bytes of the relator
+        ///
+        size_t get_bytes() const;
+        
         //
-        // Casts this Relator to an std::size_t
+        // Casts this Relator to an std::size_t, its hash. The hash is kept up to
+        // date by the moves, so this is O(1).
         //
         operator std::size_t() const;
         
@@ -82,6 +212,24 @@ namespace andrews_curtis
         ///
         std::string to_string() const;
         
+        ///
+        /// Writes this Relator, its number of letters and then its Blocks, to
+        /// the passed file
+        ///
+        /// \param file The file to write to
+        /// \return A bool indicating if the Relator was written
+        ///
+        bool write(std::FILE *file) const;
+        
+        ///
+        /// Reads this Relator, as written by write(), from the passed file
+        ///
+        /// \param file The file to read from
+        /// \return A bool indicating if a Relator was read, false at the end of
+        ///         the file
+        ///
+        bool read(std::FILE *file);
+        
         ///
         /// Operator assignment
         ///
@@ -139,7 +287,145 @@ namespace andrews_curtis
         bool operator>=(const Relator &rhs) const;
         
     private:
-        /// Note: The relator payload m_relator is represented as a dynamic_bitset
+        //
+        // Returns the Blocks holding the letters of this Relator
+        //
+        // \return The Blocks holding the letters of this Relator
+        //
+        Block *get_blocks();
+        
+        //
+        // Returns the Blocks holding the letters of this Relator
+        //
+        // \return The Blocks holding the letters of this Relator
+        //
+        const Block *get_blocks() const;
+        
+        //
+        // Returns the number of Blocks holding the letters of this Relator
+        //
+        // \return The number of Blocks holding the letters of this Relator
+        //
+        size_t get_block_count() const;
+        
+        //
+        // Returns the bits of the letter at the passed index
+        //
+        // \param index The index of the letter to return
+        // \return The bits of the letter at index
+        //
+        unsigned int get_letter(size_t index) const;
+        
+        //
+        // Returns the bits of the letter at the passed index, for letters of
+        // Bits bits. As Bits is known at compile time, finding the letter's
+        // Block and position in it is a shift and a mask, not a division.
+        //
+        // \param index The index of the letter to return
+        // \return The bits of the letter at index
+        //
+        template <unsigned int Bits> unsigned int get_letter(size_t index) const;
+        
+        //
+        // Sets the bits of the letter at the passed index, the letter at index
+        // must be zero before this call.
+        //
+        // \param index The index of the letter to set
+        // \param bits The bits of the letter to set
+        //
+        void set_letter(size_t index, unsigned int bits);
+        
+        //
+        // Sets the bits of the letter at the passed index, for letters of Bits
+        // bits, the letter at index must be zero before this call.
+        //
+        // \param index The index of the letter to set
+        // \param bits The bits of the letter to set
+        //
+        template <unsigned int Bits> void set_letter(size_t index, unsigned int bits);
+        
+        //
+        // Sets the letters, which must be zero before this call, to the bits of
+        // the first m_length chars of the passed string, for letters of Bits bits
+        //
+        // \param relator The string of the letters
+        //
+        template <unsigned int Bits> void set_letters(const char *relator);
+        
+        //
+        // Appends the chars of the letters to the passed string, for letters of
+        // Bits bits
+        //
+        // \param relator The string to append the letters to
+        //
+        template <unsigned int Bits> void append_letters(std::string &relator) const;
+        
+        //
+        // Recomputes m_hash and m_inverse_hash from the letters
+        //
+        void rehash();
+        
+        //
+        // Recomputes m_hash and m_inverse_hash from the letters, for letters
+        // of Bits bits
+        //
+        template <unsigned int Bits> void rehash();
+        
+        //
+        // Relabels the letters of the Relator in place, for letters of Bits
+        // bits, see relabel(const unsigned int*)
+        //
+        // \param letters The table of relabeled letters
+        //
+        template <unsigned int Bits> void relabel_letters(const unsigned int *letters);
+        
+        //
+        // Computes the hashes the Relator would have after conjugate(generator)
+        //
+        // \param generator The generator to conjugate by
+        // \param hash Set to the hash of the conjugate
+        // \param inverse_hash Set to the hash of the inverse of the conjugate
+        //
+        void get_conjugate_hashes(int generator, boost::uint64_t &hash, boost::uint64_t &inverse_hash) const;
+        
+        //
+        // Computes the hashes the Relator would have after multiply(relator),
+        // given the number of letters cancelled in the product
+        //
+        // \param relator The Relator to multiply on the right with
+        // \param cancelation_count The number of letters cancelled in the product
+        // \param hash Set to the hash of the product
+        // \param inverse_hash Set to the hash of the inverse of the product
+        //
+        void get_product_hashes(const Relator *relator, size_t cancelation_count, boost::uint64_t &hash, boost::uint64_t &inverse_hash) const;
+        
+        //
+        // Allocates heap Blocks. The number of Blocks is rounded up to a power
+        // of 2, so Blocks of similar numbers share slabs.
+        //
+        // \param capacity The least number of Blocks, set to the number allocated
+        // \return The allocated Blocks
+        //
+        static Block *allocate_blocks(size_t &capacity);
+        
+        //
+        // Frees heap Blocks allocated by allocate_blocks()
+        //
+        // \param blocks The Blocks to free
+        // \param capacity The number of Blocks allocated
+        //
+        static void free_blocks(Block *blocks, size_t capacity);
+        
+        //
+        // Resizes the Blocks to hold the passed number of letters, zeroing any
+        // bits above the last letter. Allocates only if the letters no longer
+        // fit in the Blocks already held.
+        //
+        // \param length The new number of letters
+        //
+        void resize(size_t length);
+        
+        /// Note: The relator payload is represented as packed letters.
         /// A more conventional means of representing the relator would have been
         /// through a size, capacity, and a int* where the int* points to an array
         /// of ints each of which represents a letter in the relator. However, as
@@ -147,33 +433,61 @@ namespace andrews_curtis
         /// most common number, using an int to hold four values is wasting 61bits
         /// on a 64bit machine. So, for 10's to 100's of millions of Relators with
         /// an average length of 40 this wastes 3.05 to 30.50GB! Yes, GB!!!
+        ///
+        /// Letters are packed g_bits_per_letter bits at a time into Blocks, the
+        /// letter at index 0 in the least significant bits of the first Block.
+        /// As g_bits_per_letter divides s_bits_per_block no letter straddles two
+        /// Blocks, so moves can shift, reverse, and compare a whole Block, i.e.
+        /// g_letters_per_block letters, at a time. All bits above the last letter
+        /// are kept zero so Blocks may be compared directly.
+        
+        /// Note: Letters are 4 bits for up to 7 generators and 8 bits otherwise,
+        /// so the letter loops are instantiated for both widths and picked by
+        /// g_bits_per_letter. The instantiations see the width as a constant.
+        
+        /// Note: Most relators are only 10's of letters long, so the Blocks of a
+        /// short relator are kept in the Relator itself, m_inline_blocks, and a
+        /// heap allocation, m_heap_blocks, is only made for long relators. This
+        /// saves a malloc/free pair for almost every Relator created while also
+        /// saving the allocator's per chunk overhead.
+        
+        /// Note: Heap Blocks, and the Relators of the Relator_table, are carved
+        /// from large slabs by a Slab_allocator per size rather than allocated one
+        /// by one, so threads allocate without contending for the heap, and there
+        /// is no per allocation header. The slabs are returned in bulk by release().
+        
+        /// Note: Each relator carries a polynomial hash of its letters, the sum
+        /// of letter[i]*B^i modulo the Mersenne prime 2^61-1, for a fixed base B.
+        /// The hash of the relator's inverse is also kept, so that each move can
+        /// update both from the letters it adds or drops, without re-reading the
+        /// word. In particular invert simply swaps the two.
         
-        /// The relator
-        boost::dynamic_bitset<> m_relator;
+        /// The hash of the relator
+        boost::uint64_t m_hash;
         
+        /// The hash of the inverse of the relator
+        boost::uint64_t m_inverse_hash;
         
-        /// Note: In addition, an instance of this class representes a node in a
-        /// binary search tree. Normally this would be an odd situation, but, as
-        /// all Relators are eventually stored in a binary search tree, this ac-
-        /// tually saves memory, dispite being odd from an OO perspective.
+        /// The number of letters in the relator
+        unsigned int m_length;
         
-        /// Indicate Binary_tree<Relator> is a friend
-        friend class Binary_tree<Relator>;
+        /// The number of Blocks in m_heap_blocks, or 0 if m_inline_blocks is used
+        unsigned int m_capacity;
         
-        /// Note: Having the Relator be a Relator and a node in a ST allows for 
-        /// saving of one pointer per Relator. If all relators were stored in an
-        /// external ST class, then for any Relator there would be a Node which
-        /// would contain two pointers, one for the let and right Node,  as well
-        /// as a pointer to the contained Relator. This pointer to the contained
-        /// Relator is not needed in our case as the Node is the Relator itself. 
-        /// With 10's to 100's of millions of Relators this will save us from 80
-        /// to 800 MB or more! (One 64 bit pointer per Relator.)
+        /// The letters of the relator
+        union
+        {
+            /// The letters of a relator of at most s_inline_blocks Blocks
+            Block m_inline_blocks[s_inline_blocks];
+            
+            /// The letters of a relator of more than s_inline_blocks Blocks
+            Block *m_heap_blocks;
+        };
         
-        /// Left subtree of this Relator's scapegoat tree
-        Relator *m_left;
         
-        /// Right subtree of this Relator's scapegoat tree
-        Relator *m_right;
+        /// Note: Relators are not held by presentations directly but interned in
+        /// the Relator_table, which stores each distinct Relator once and hands
+        /// out a 32 bit id for it. See relator_table.h.
         
         
         // Indicate boost::serialization::access is a friend for serialization
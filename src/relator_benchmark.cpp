@@ -0,0 +1,174 @@
+//
+//  relator_benchmark.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "relator_kernels.h"
+
+using namespace andrews_curtis;
+
+// Typedefs
+typedef Relator_kernels::Block Block;
+
+// Utility function that counts cancellations a letter at a time, as Relator::multiply once did
+static size_t letter_cancellation_length(const Block *blocks1,size_t length1,
+                                         const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+
+// Utility function that returns the microseconds taken by iterations calls of kernel
+template <class Kernel> static double time_kernel(Kernel kernel,unsigned long iterations);
+
+// Cancellation kernel adaptor for time_kernel
+struct Cancellation
+{
+    size_t (*m_kernel)(const Block*,size_t,const Block*,size_t,unsigned int);
+    const std::vector<Block> *m_blocks1;
+    const std::vector<Block> *m_blocks2;
+    size_t m_length;
+    unsigned int m_bits_per_letter;
+    size_t operator()() const
+    {
+        return m_kernel(&(*m_blocks1)[0], m_length, &(*m_blocks2)[0], m_length, m_bits_per_letter);
+    }
+};
+
+// Reverse and invert kernel adaptor for time_kernel
+struct Reversal
+{
+    void (*m_kernel)(Block*,size_t,unsigned int);
+    std::vector<Block> *m_blocks;
+    unsigned int m_bits_per_letter;
+    size_t operator()() const
+    {
+        m_kernel(&(*m_blocks)[0], m_blocks->size(), m_bits_per_letter);
+        return (*m_blocks)[0];
+    }
+};
+
+int main()
+{
+    // Use nibble letters, as for up to seven generators
+    const unsigned int bits_per_letter = 4;
+    
+    // Obtain the number of letters in a Block
+    const size_t letters_per_block = Relator::s_bits_per_block / bits_per_letter;
+    
+    // Print the kernel variant in use
+    std::cout << "Kernel variant: " << Relator_kernels::get_variant_name() << std::endl;
+    
+    // Loop over relator lengths, each word wholly cancelling the other
+    for(size_t length = 16; length <= 4096; length *= 4)
+    {
+        // Obtain the number of Blocks
+        size_t block_count = (length + letters_per_block - 1) / letters_per_block;
+        
+        // Define the words r and s = r^-1
+        std::vector<Block> blocks1(block_count, 0);
+        std::vector<Block> blocks2(block_count, 0);
+        
+        // Fill r with random letters from a, b, A, B
+        for(size_t letter = 0; letter < length; ++letter)
+        {
+            static const unsigned int letters[] = {0x1, 0x2, 0xE, 0xD};
+            blocks1[letter / letters_per_block] |= static_cast<Block>(letters[std::rand() % 4]) << ((letter % letters_per_block) * bits_per_letter);
+        }
+        
+        // Set s to r^-1, reversing and inverting r, then shifting out the padding
+        blocks2 = blocks1;
+        Relator_kernels::scalar_reverse_invert(&blocks2[0], block_count, bits_per_letter);
+        unsigned int padding = (block_count * letters_per_block - length) * bits_per_letter;
+        for(size_t index = 0; padding && (index < block_count); ++index)
+            blocks2[index] = (blocks2[index] >> padding) | (((index + 1) < block_count) ? (blocks2[index + 1] << (Relator::s_bits_per_block - padding)) : 0);
+        
+        // Scale iterations so each measurement does similar work
+        unsigned long iterations = 50000000 / length;
+        
+        // Time the cancellation kernels
+        Cancellation letter = {letter_cancellation_length, &blocks1, &blocks2, length, bits_per_letter};
+        Cancellation scalar = {Relator_kernels::scalar_cancellation_length, &blocks1, &blocks2, length, bits_per_letter};
+        Cancellation selected = {Relator_kernels::cancellation_length, &blocks1, &blocks2, length, bits_per_letter};
+        double letter_time = time_kernel(letter, iterations);
+        double scalar_time = time_kernel(scalar, iterations);
+        double selected_time = time_kernel(selected, iterations);
+        
+        // Time the reverse and invert kernels
+        Reversal scalar_reversal = {Relator_kernels::scalar_reverse_invert, &blocks1, bits_per_letter};
+        Reversal selected_reversal = {Relator_kernels::reverse_invert, &blocks1, bits_per_letter};
+        double scalar_reversal_time = time_kernel(scalar_reversal, iterations);
+        double selected_reversal_time = time_kernel(selected_reversal, iterations);
+        
+        // Print the results in ns per call
+        std::cout << "Length " << length << ":" << std::endl;
+        std::cout << "\tCancellation (letter): " << 1000 * letter_time / iterations << "ns" << std::endl;
+        std::cout << "\tCancellation (scalar): " << 1000 * scalar_time / iterations << "ns" << std::endl;
+        std::cout << "\tCancellation (" << Relator_kernels::get_variant_name() << "): " << 1000 * selected_time / iterations << "ns"
+                  << " speedup " << letter_time / selected_time << "x over letter, " << scalar_time / selected_time << "x over scalar" << std::endl;
+        std::cout << "\tReverse and invert (scalar): " << 1000 * scalar_reversal_time / iterations << "ns" << std::endl;
+        std::cout << "\tReverse and invert (" << Relator_kernels::get_variant_name() << "): " << 1000 * selected_reversal_time / iterations << "ns"
+                  << " speedup " << scalar_reversal_time / selected_reversal_time << "x" << std::endl;
+    }
+    
+    // Return success
+    return 0;
+}
+
+size_t letter_cancellation_length(const Block *blocks1,size_t length1,
+                                  const Block *blocks2,size_t length2,unsigned int bits_per_letter)
+{
+    // Obtain the number of letters in a Block
+    size_t letters_per_block = Relator::s_bits_per_block / bits_per_letter;
+    
+    // Obtain the mask of a letter
+    Block mask = (static_cast<Block>(0x1) << bits_per_letter) - 1;
+    
+    // Determine min of length1 and length2
+    size_t min_length = (length1 < length2) ? length1 : length2;
+    
+    // Loop over letters until a letter does not cancel
+    size_t cancelation_count = 0;
+    for(; cancelation_count < min_length; ++cancelation_count)
+    {
+        // Obtain the letter of the first word
+        size_t index1 = length1 - cancelation_count - 1;
+        Block letter1 = (blocks1[index1 / letters_per_block] >> ((index1 % letters_per_block) * bits_per_letter)) & mask;
+        
+        // Obtain the letter of the second word
+        size_t index2 = cancelation_count;
+        Block letter2 = (blocks2[index2 / letters_per_block] >> ((index2 % letters_per_block) * bits_per_letter)) & mask;
+        
+        // Check for lack of cancelation
+        if(letter1 != (letter2 ^ mask))
+            break;
+    }
+    
+    // Return the count
+    return cancelation_count;
+}
+
+template <class Kernel>
+double time_kernel(Kernel kernel,unsigned long iterations)
+{
+    // Define a sink so calls are not optimized away
+    volatile size_t sink = 0;
+    
+    // Obtain start time
+    boost::posix_time::ptime start_time(boost::posix_time::microsec_clock::local_time());
+    
+    // Call kernel iterations times
+    for(unsigned long iteration = 0; iteration < iterations; ++iteration)
+        sink = sink + kernel();
+    
+    // Obtain stop time
+    boost::posix_time::ptime stop_time(boost::posix_time::microsec_clock::local_time());
+    
+    // Return the microseconds taken
+    return (stop_time - start_time).total_microseconds();
+}
@@ -0,0 +1,51 @@
+//
+//  relator_kernels-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_relator_kernels_inl_h
+#define Andrews_Curtis_Conjecture_relator_kernels_inl_h
+
+
+namespace andrews_curtis
+{
+    inline Relator_kernels::Block Relator_kernels::reverse_letters(Block block,unsigned int bits_per_letter)
+    {
+        // Reverse the bytes of block
+        block = __builtin_bswap64(block);
+        
+        // If letters are nibbles, reverse the nibbles in each byte too
+        if(4 == bits_per_letter)
+            block = ((block >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((block & 0x0F0F0F0F0F0F0F0FULL) << 4);
+        
+        // Return the reversed block
+        return block;
+    }
+    
+    inline Relator_kernels::Block Relator_kernels::read_block(const Block *blocks,size_t block_count,long bit)
+    {
+        // If bit is before the first Block, read from the first Block and shift in zeros
+        if(bit < 0)
+            return (-bit < Relator::s_bits_per_block) ? (read_block(blocks, block_count, 0) << -bit) : 0;
+        
+        // Obtain the index of the Block containing bit
+        size_t index = bit / Relator::s_bits_per_block;
+        
+        // Obtain the offset of bit in its Block
+        unsigned int offset = bit % Relator::s_bits_per_block;
+        
+        // Obtain the bits from the Block containing bit
+        Block low = (index < block_count) ? (blocks[index] >> offset) : 0;
+        
+        // Obtain the bits from the following Block
+        Block high = (offset && ((index + 1) < block_count)) ? (blocks[index + 1] << (Relator::s_bits_per_block - offset)) : 0;
+        
+        // Return the combined bits
+        return low | high;
+    }
+}
+
+#endif
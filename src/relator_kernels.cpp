@@ -0,0 +1,469 @@
+//
+//  relator_kernels.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "relator_kernels.h"
+
+
+namespace andrews_curtis
+{
+    // Typedefs
+    typedef Relator_kernels::Block Block;
+    typedef void (*Reverse_invert)(Block *blocks,size_t block_count,unsigned int bits_per_letter);
+    typedef size_t (*Cancellation_length)(const Block *blocks1,size_t length1,
+                                          const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+    
+    // Utility function that reverses and inverts a Block at a time
+    static void reverse_invert_scalar(Block *blocks,size_t block_count,unsigned int bits_per_letter);
+    
+    // Utility function that counts cancellations a Block at a time, starting after cancelation_count cancellations
+    static size_t cancellation_length_scalar(const Block *blocks1,size_t length1,
+                                             const Block *blocks2,size_t length2,
+                                             unsigned int bits_per_letter,size_t cancelation_count);
+    
+    // Utility function that counts cancellations a Block at a time
+    static size_t cancellation_length_scalar(const Block *blocks1,size_t length1,
+                                             const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+    
+#if defined(__x86_64__) || defined(__i386__)
+    // Utility function that reverses and inverts two Blocks at a time using SSSE3
+    __attribute__((target("ssse3")))
+    static void reverse_invert_ssse3(Block *blocks,size_t block_count,unsigned int bits_per_letter);
+    
+    // Utility function that reverses and inverts four Blocks at a time using AVX2
+    __attribute__((target("avx2")))
+    static void reverse_invert_avx2(Block *blocks,size_t block_count,unsigned int bits_per_letter);
+    
+    // Utility function that counts cancellations two Blocks at a time using SSSE3
+    __attribute__((target("ssse3")))
+    static size_t cancellation_length_ssse3(const Block *blocks1,size_t length1,
+                                            const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+    
+    // Utility function that counts cancellations four Blocks at a time using AVX2
+    __attribute__((target("avx2")))
+    static size_t cancellation_length_avx2(const Block *blocks1,size_t length1,
+                                           const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+#endif
+    
+    // Utility function that selects the fastest kernel variants for this CPU
+    static const char *select_variant(Reverse_invert *reverse_invert,Cancellation_length *cancellation_length);
+    
+    // The number of Blocks below which the scalar variants are used
+    static const size_t s_vector_blocks = 4;
+    
+    // The selected reverse_invert variant
+    static Reverse_invert s_reverse_invert = 0;
+    
+    // The selected cancellation_length variant
+    static Cancellation_length s_cancellation_length = 0;
+    
+    // The name of the selected variants
+    static const char *s_variant_name = select_variant(&s_reverse_invert, &s_cancellation_length);
+    
+    
+    void Relator_kernels::reverse_invert(Block *blocks,size_t block_count,unsigned int bits_per_letter)
+    {
+        // Short words are faster to reverse without vectors
+        if(block_count < s_vector_blocks)
+            reverse_invert_scalar(blocks, block_count, bits_per_letter);
+        else
+            s_reverse_invert(blocks, block_count, bits_per_letter);
+    }
+    
+    void Relator_kernels::scalar_reverse_invert(Block *blocks,size_t block_count,unsigned int bits_per_letter)
+    {
+        reverse_invert_scalar(blocks, block_count, bits_per_letter);
+    }
+    
+    size_t Relator_kernels::cancellation_length(const Block *blocks1,size_t length1,
+                                                const Block *blocks2,size_t length2,unsigned int bits_per_letter)
+    {
+        // Obtain the number of letters in s_vector_blocks Blocks
+        size_t vector_letters = s_vector_blocks * (Relator::s_bits_per_block / bits_per_letter);
+        
+        // Short words are faster to scan without vectors
+        if((length1 < vector_letters) || (length2 < vector_letters))
+            return cancellation_length_scalar(blocks1, length1, blocks2, length2, bits_per_letter);
+        else
+            return s_cancellation_length(blocks1, length1, blocks2, length2, bits_per_letter);
+    }
+    
+    size_t Relator_kernels::scalar_cancellation_length(const Block *blocks1,size_t length1,
+                                                       const Block *blocks2,size_t length2,unsigned int bits_per_letter)
+    {
+        return cancellation_length_scalar(blocks1, length1, blocks2, length2, bits_per_letter);
+    }
+    
+    const char *Relator_kernels::get_variant_name()
+    {
+        return s_variant_name;
+    }
+    
+    const char *select_variant(Reverse_invert *reverse_invert,Cancellation_length *cancellation_length)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        // Initialize CPU feature detection, we may run before any constructor
+        __builtin_cpu_init();
+        
+        // Use AVX2 if present
+        if(__builtin_cpu_supports("avx2"))
+        {
+            *reverse_invert = reverse_invert_avx2;
+            *cancellation_length = cancellation_length_avx2;
+            return "avx2";
+        }
+        
+        // Use SSSE3 if present
+        if(__builtin_cpu_supports("ssse3"))
+        {
+            *reverse_invert = reverse_invert_ssse3;
+            *cancellation_length = cancellation_length_ssse3;
+            return "ssse3";
+        }
+#endif
+        
+        // Fall back to the scalar variants
+        *reverse_invert = reverse_invert_scalar;
+        *cancellation_length = cancellation_length_scalar;
+        return "scalar";
+    }
+    
+    void reverse_invert_scalar(Block *blocks,size_t block_count,unsigned int bits_per_letter)
+    {
+        // Loop over "half" the Blocks swapping them, reversing and inverting their letters (Note: one's compliment)
+        for(size_t index = 0; index < (block_count/2); ++index)
+        {
+            // Reverse and invert the low Block
+            Block low = ~Relator_kernels::reverse_letters(blocks[index], bits_per_letter);
+            
+            // Reverse and invert the high Block into the low Block
+            blocks[index] = ~Relator_kernels::reverse_letters(blocks[block_count - index - 1], bits_per_letter);
+            
+            // Place the low Block in the high Block
+            blocks[block_count - index - 1] = low;
+        }
+        
+        // If there is a middle Block, reverse and invert it in place
+        if(1 == (block_count % 2))
+            blocks[block_count/2] = ~Relator_kernels::reverse_letters(blocks[block_count/2], bits_per_letter);
+    }
+    
+    size_t cancellation_length_scalar(const Block *blocks1,size_t length1,
+                                      const Block *blocks2,size_t length2,
+                                      unsigned int bits_per_letter,size_t cancelation_count)
+    {
+        // Obtain the number of letters in a Block
+        size_t letters_per_block = Relator::s_bits_per_block / bits_per_letter;
+        
+        // Obtain the number of Blocks of each word
+        size_t block_count1 = (length1 + letters_per_block - 1) / letters_per_block;
+        size_t block_count2 = (length2 + letters_per_block - 1) / letters_per_block;
+        
+        // Determine min of length1 and length2
+        size_t min_length = (length1 < length2) ? length1 : length2;
+        
+        // Determine actual new length based on cancelations, a Block of letters at a time
+        while(cancelation_count < min_length)
+        {
+            // Obtain the first bit of the Block of letters of the first word preceding the cancelled letters
+            long bit = (static_cast<long>(length1 - cancelation_count) - static_cast<long>(letters_per_block)) * bits_per_letter;
+            
+            // Obtain the Block of letters of the first word, reversed and inverted, preceding the cancelled letters
+            Block tail = ~Relator_kernels::reverse_letters(Relator_kernels::read_block(blocks1, block_count1, bit), bits_per_letter);
+            
+            // Obtain the Block of letters of the second word following the cancelled letters
+            Block head = Relator_kernels::read_block(blocks2, block_count2, cancelation_count*bits_per_letter);
+            
+            // Letters which cancel are equal in tail and head
+            Block difference = tail ^ head;
+            
+            // If all letters cancel, move on to the next Block
+            if(!difference)
+            {
+                // Increment cancelation_count
+                cancelation_count += letters_per_block;
+                
+                // Continue to while
+                continue;
+            }
+            
+            // Increment cancelation_count by the letters cancelled before the first difference
+            cancelation_count += __builtin_ctzll(difference) / bits_per_letter;
+            
+            // Break out of the loop, non-concident cancelations can't occur
+            break;
+        }
+        
+        // Letters beyond the shorter word can not cancel
+        return (cancelation_count < min_length) ? cancelation_count : min_length;
+    }
+    
+    size_t cancellation_length_scalar(const Block *blocks1,size_t length1,
+                                      const Block *blocks2,size_t length2,unsigned int bits_per_letter)
+    {
+        return cancellation_length_scalar(blocks1, length1, blocks2, length2, bits_per_letter, 0);
+    }
+    
+#if defined(__x86_64__) || defined(__i386__)
+    void reverse_invert_ssse3(Block *blocks,size_t block_count,unsigned int bits_per_letter)
+    {
+        // Define the shuffle reversing the bytes of a vector
+        const __m128i reverse_bytes = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+        
+        // Define the mask selecting the low nibble of each byte
+        const __m128i low_nibbles = _mm_set1_epi8(0x0F);
+        
+        // Define the mask inverting every bit
+        const __m128i ones = _mm_set1_epi8(-1);
+        
+        // Define the first and one past the last Block not yet reversed
+        Block *low = blocks;
+        Block *high = blocks + block_count;
+        
+        // Loop over two Blocks from each end at a time
+        while((high - low) >= 4)
+        {
+            // Load two Blocks from each end
+            __m128i low_vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low));
+            __m128i high_vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high - 2));
+            
+            // Reverse the bytes, and so the Blocks, of each vector
+            low_vector = _mm_shuffle_epi8(low_vector, reverse_bytes);
+            high_vector = _mm_shuffle_epi8(high_vector, reverse_bytes);
+            
+            // If letters are nibbles, reverse the nibbles in each byte too
+            if(4 == bits_per_letter)
+            {
+                low_vector = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(low_vector, 4), low_nibbles),
+                                          _mm_slli_epi16(_mm_and_si128(low_vector, low_nibbles), 4));
+                high_vector = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(high_vector, 4), low_nibbles),
+                                           _mm_slli_epi16(_mm_and_si128(high_vector, low_nibbles), 4));
+            }
+            
+            // Store the inverted vectors at the opposite ends
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(low), _mm_xor_si128(high_vector, ones));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(high - 2), _mm_xor_si128(low_vector, ones));
+            
+            // Move towards the middle
+            low += 2;
+            high -= 2;
+        }
+        
+        // Reverse and invert the remaining middle Blocks
+        reverse_invert_scalar(low, high - low, bits_per_letter);
+    }
+    
+    void reverse_invert_avx2(Block *blocks,size_t block_count,unsigned int bits_per_letter)
+    {
+        // Define the shuffle reversing the bytes of each 128 bit lane
+        const __m256i reverse_bytes = _mm256_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+                                                      0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+        
+        // Define the mask selecting the low nibble of each byte
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+        
+        // Define the mask inverting every bit
+        const __m256i ones = _mm256_set1_epi8(-1);
+        
+        // Define the first and one past the last Block not yet reversed
+        Block *low = blocks;
+        Block *high = blocks + block_count;
+        
+        // Loop over four Blocks from each end at a time
+        while((high - low) >= 8)
+        {
+            // Load four Blocks from each end
+            __m256i low_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low));
+            __m256i high_vector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high - 4));
+            
+            // Reverse the bytes of each lane, then swap the lanes, reversing the vector
+            low_vector = _mm256_shuffle_epi8(low_vector, reverse_bytes);
+            low_vector = _mm256_permute2x128_si256(low_vector, low_vector, 0x01);
+            high_vector = _mm256_shuffle_epi8(high_vector, reverse_bytes);
+            high_vector = _mm256_permute2x128_si256(high_vector, high_vector, 0x01);
+            
+            // If letters are nibbles, reverse the nibbles in each byte too
+            if(4 == bits_per_letter)
+            {
+                low_vector = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(low_vector, 4), low_nibbles),
+                                             _mm256_slli_epi16(_mm256_and_si256(low_vector, low_nibbles), 4));
+                high_vector = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(high_vector, 4), low_nibbles),
+                                              _mm256_slli_epi16(_mm256_and_si256(high_vector, low_nibbles), 4));
+            }
+            
+            // Store the inverted vectors at the opposite ends
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(low), _mm256_xor_si256(high_vector, ones));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(high - 4), _mm256_xor_si256(low_vector, ones));
+            
+            // Move towards the middle
+            low += 4;
+            high -= 4;
+        }
+        
+        // Reverse and invert the remaining middle Blocks two at a time
+        reverse_invert_ssse3(low, high - low, bits_per_letter);
+    }
+    
+    size_t cancellation_length_ssse3(const Block *blocks1,size_t length1,
+                                     const Block *blocks2,size_t length2,unsigned int bits_per_letter)
+    {
+        // Define the shuffle reversing the bytes of a vector
+        const __m128i reverse_bytes = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+        
+        // Define the mask selecting the low nibble of each byte
+        const __m128i low_nibbles = _mm_set1_epi8(0x0F);
+        
+        // Define the mask inverting every bit
+        const __m128i ones = _mm_set1_epi8(-1);
+        
+        // Obtain the number of letters in two Blocks
+        size_t letters_per_step = 2 * (Relator::s_bits_per_block / bits_per_letter);
+        
+        // Determine min of length1 and length2
+        size_t min_length = (length1 < length2) ? length1 : length2;
+        
+        // Obtain the offset, within its Block, of the end of the first word (Note: fixed as we step whole Blocks)
+        unsigned int offset = (length1 * bits_per_letter) % Relator::s_bits_per_block;
+        
+        // Obtain the shift counts aligning the end of the first word to a Block
+        const __m128i low_shift = _mm_cvtsi32_si128(offset);
+        const __m128i high_shift = _mm_cvtsi32_si128(Relator::s_bits_per_block - offset);
+        
+        // Define cancelation_count to count the cancelations
+        size_t cancelation_count = 0;
+        
+        // Loop over two Blocks of letters at a time
+        while((cancelation_count + letters_per_step) <= min_length)
+        {
+            // Obtain the index of the Block holding the first of the two Blocks of the first word's letters
+            size_t index = ((length1 - cancelation_count - letters_per_step) * bits_per_letter) / Relator::s_bits_per_block;
+            
+            // Load the Blocks holding the letters, and, if unaligned, the following Blocks
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks1 + index));
+            __m128i high = offset ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks1 + index + 1)) : low;
+            
+            // Align the letters to Blocks (Note: a shift by s_bits_per_block yields 0)
+            __m128i tail = _mm_or_si128(_mm_srl_epi64(low, low_shift), _mm_sll_epi64(high, high_shift));
+            
+            // Reverse the bytes of the letters
+            tail = _mm_shuffle_epi8(tail, reverse_bytes);
+            
+            // If letters are nibbles, reverse the nibbles in each byte too
+            if(4 == bits_per_letter)
+                tail = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(tail, 4), low_nibbles),
+                                    _mm_slli_epi16(_mm_and_si128(tail, low_nibbles), 4));
+            
+            // Invert the letters
+            tail = _mm_xor_si128(tail, ones);
+            
+            // Load the Blocks of the second word following the cancelled letters
+            __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks2 + (cancelation_count * bits_per_letter) / Relator::s_bits_per_block));
+            
+            // Letters which cancel are equal in tail and head
+            __m128i difference = _mm_xor_si128(tail, head);
+            
+            // If all letters cancel, move on to the next two Blocks
+            if(0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())))
+            {
+                // Increment cancelation_count
+                cancelation_count += letters_per_step;
+                
+                // Continue to while
+                continue;
+            }
+            
+            // Finish the count a Block at a time, starting from the two differing Blocks
+            break;
+        }
+        
+        // Count the remaining cancellations a Block at a time
+        return cancellation_length_scalar(blocks1, length1, blocks2, length2, bits_per_letter, cancelation_count);
+    }
+    
+    size_t cancellation_length_avx2(const Block *blocks1,size_t length1,
+                                    const Block *blocks2,size_t length2,unsigned int bits_per_letter)
+    {
+        // Define the shuffle reversing the bytes of each 128 bit lane
+        const __m256i reverse_bytes = _mm256_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+                                                      0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+        
+        // Define the mask selecting the low nibble of each byte
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+        
+        // Define the mask inverting every bit
+        const __m256i ones = _mm256_set1_epi8(-1);
+        
+        // Obtain the number of letters in four Blocks
+        size_t letters_per_step = 4 * (Relator::s_bits_per_block / bits_per_letter);
+        
+        // Determine min of length1 and length2
+        size_t min_length = (length1 < length2) ? length1 : length2;
+        
+        // Obtain the offset, within its Block, of the end of the first word (Note: fixed as we step whole Blocks)
+        unsigned int offset = (length1 * bits_per_letter) % Relator::s_bits_per_block;
+        
+        // Obtain the shift counts aligning the end of the first word to a Block
+        const __m128i low_shift = _mm_cvtsi32_si128(offset);
+        const __m128i high_shift = _mm_cvtsi32_si128(Relator::s_bits_per_block - offset);
+        
+        // Define cancelation_count to count the cancelations
+        size_t cancelation_count = 0;
+        
+        // Loop over four Blocks of letters at a time
+        while((cancelation_count + letters_per_step) <= min_length)
+        {
+            // Obtain the index of the Block holding the first of the four Blocks of the first word's letters
+            size_t index = ((length1 - cancelation_count - letters_per_step) * bits_per_letter) / Relator::s_bits_per_block;
+            
+            // Load the Blocks holding the letters, and, if unaligned, the following Blocks
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks1 + index));
+            __m256i high = offset ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks1 + index + 1)) : low;
+            
+            // Align the letters to Blocks (Note: a shift by s_bits_per_block yields 0)
+            __m256i tail = _mm256_or_si256(_mm256_srl_epi64(low, low_shift), _mm256_sll_epi64(high, high_shift));
+            
+            // Reverse the bytes of each lane, then swap the lanes, reversing the vector
+            tail = _mm256_shuffle_epi8(tail, reverse_bytes);
+            tail = _mm256_permute2x128_si256(tail, tail, 0x01);
+            
+            // If letters are nibbles, reverse the nibbles in each byte too
+            if(4 == bits_per_letter)
+                tail = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(tail, 4), low_nibbles),
+                                       _mm256_slli_epi16(_mm256_and_si256(tail, low_nibbles), 4));
+            
+            // Invert the letters
+            tail = _mm256_xor_si256(tail, ones);
+            
+            // Load the Blocks of the second word following the cancelled letters
+            __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(blocks2 + (cancelation_count * bits_per_letter) / Relator::s_bits_per_block));
+            
+            // Letters which cancel are equal in tail and head
+            __m256i difference = _mm256_xor_si256(tail, head);
+            
+            // If all letters cancel, move on to the next four Blocks
+            if(_mm256_testz_si256(difference, difference))
+            {
+                // Increment cancelation_count
+                cancelation_count += letters_per_step;
+                
+                // Continue to while
+                continue;
+            }
+            
+            // Finish the count a Block at a time, starting from the four differing Blocks
+            break;
+        }
+        
+        // Count the remaining cancellations a Block at a time
+        return cancellation_length_scalar(blocks1, length1, blocks2, length2, bits_per_letter, cancelation_count);
+    }
+#endif
+}
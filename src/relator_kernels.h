@@ -0,0 +1,113 @@
+//
+//  relator_kernels.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_relator_kernels_h
+#define Andrews_Curtis_Conjecture_relator_kernels_h
+
+
+#include <cstddef>
+
+#include "relator.h"
+
+
+namespace andrews_curtis
+{
+    ///
+    /// This class encapsulates the kernels that apply Andrews Curtis moves to
+    /// the Blocks of a Relator. Where the CPU allows, a kernel is vectorized;
+    /// the vectorized variant is picked once, at runtime, by CPU feature
+    /// detection, falling back to a scalar variant on other CPUs.
+    ///
+    class Relator_kernels
+    {
+    public:
+        /// The machine word in which letters are packed
+        typedef Relator::Block Block;
+        
+        ///
+        /// Reverses the order of the letters in the passed Block
+        ///
+        /// \param block The Block to reverse
+        /// \param bits_per_letter The number of bits in a letter, 4 or 8
+        /// \return The passed Block with its letters reversed
+        ///
+        static Block reverse_letters(Block block,unsigned int bits_per_letter);
+        
+        ///
+        /// Reads s_bits_per_block bits of the passed Blocks starting at the passed
+        /// bit, the bits outside the Blocks read as 0.
+        ///
+        /// \param blocks The Blocks to read from
+        /// \param block_count The number of Blocks in blocks
+        /// \param bit The first bit to read, may be negative
+        /// \return The bits read
+        ///
+        static Block read_block(const Block *blocks,size_t block_count,long bit);
+        
+        ///
+        /// Reverses the order of the letters in the passed Blocks and inverts
+        /// each letter, i.e. flips all its bits. The bits above the last letter
+        /// are reversed and inverted too, so they end up, as ones, below the
+        /// first letter.
+        ///
+        /// \param blocks The Blocks to reverse and invert
+        /// \param block_count The number of Blocks to reverse and invert
+        /// \param bits_per_letter The number of bits in a letter, 4 or 8
+        ///
+        static void reverse_invert(Block *blocks,size_t block_count,unsigned int bits_per_letter);
+        
+        ///
+        /// The scalar variant of reverse_invert
+        ///
+        /// \param blocks The Blocks to reverse and invert
+        /// \param block_count The number of Blocks to reverse and invert
+        /// \param bits_per_letter The number of bits in a letter, 4 or 8
+        ///
+        static void scalar_reverse_invert(Block *blocks,size_t block_count,unsigned int bits_per_letter);
+        
+        ///
+        /// Returns the number of letters that freely cancel in the product of
+        /// the two passed words, i.e. the number of letters at the end of the
+        /// first word that are, in reverse order, the inverses of the letters
+        /// at the start of the second word.
+        ///
+        /// \param blocks1 The Blocks of the first word
+        /// \param length1 The number of letters in the first word
+        /// \param blocks2 The Blocks of the second word
+        /// \param length2 The number of letters in the second word
+        /// \param bits_per_letter The number of bits in a letter, 4 or 8
+        /// \return The number of letters that cancel
+        ///
+        static size_t cancellation_length(const Block *blocks1,size_t length1,
+                                          const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+        
+        ///
+        /// The scalar variant of cancellation_length
+        ///
+        /// \param blocks1 The Blocks of the first word
+        /// \param length1 The number of letters in the first word
+        /// \param blocks2 The Blocks of the second word
+        /// \param length2 The number of letters in the second word
+        /// \param bits_per_letter The number of bits in a letter, 4 or 8
+        /// \return The number of letters that cancel
+        ///
+        static size_t scalar_cancellation_length(const Block *blocks1,size_t length1,
+                                                 const Block *blocks2,size_t length2,unsigned int bits_per_letter);
+        
+        ///
+        /// Returns the name of the kernel variants used on this CPU
+        ///
+        /// \return The name of the kernel variants used on this CPU
+        ///
+        static const char *get_variant_name();
+    };
+}
+
+#include "relator_kernels-inl.h"
+
+#endif
@@ -0,0 +1,42 @@
+//
+//  relator_table-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_relator_table_inl_h
+#define Andrews_Curtis_Conjecture_relator_table_inl_h
+
+
+#include <boost/thread/lock_guard.hpp>
+
+
+namespace andrews_curtis
+{
+    inline const Relator *Relator_table::get_relator(unsigned int id)
+    {
+        return s_chunks[id >> s_chunk_bits][id & ((0x1 << s_chunk_bits) - 1)];
+    }
+    
+    inline unsigned long Relator_table::size()
+    {
+        // Lock s_mutex
+        boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+        
+        // Return the size
+        return s_size;
+    }
+    
+    inline unsigned long Relator_table::length()
+    {
+        // Lock s_mutex
+        boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+        
+        // Return the length
+        return s_length;
+    }
+}
+
+#endif
@@ -0,0 +1,272 @@
+//
+//  relator_table.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+
+#include "relator.h"
+#include "relator_table.h"
+
+
+namespace andrews_curtis
+{
+    // Define Relator_table::s_shards
+    Relator_table::Shard Relator_table::s_shards[0x1 << Relator_table::s_shard_bits];
+    
+    // Define Relator_table::s_chunks
+    Relator **Relator_table::s_chunks[0x1 << (32 - Relator_table::s_chunk_bits)];
+    
+    // Define Relator_table::s_mutex
+    boost::mutex Relator_table::s_mutex;
+    
+    // Define Relator_table::s_size
+    unsigned long Relator_table::s_size = 0;
+    
+    // Define Relator_table::s_length
+    unsigned long Relator_table::s_length = 0;
+    
+    // Define Relator_table::s_bytes
+    unsigned long Relator_table::s_bytes = 0;
+    
+    
+    unsigned int Relator_table::intern(const Relator &relator)
+    {
+        // Obtain the hash of relator
+        std::size_t hash = static_cast<std::size_t>(relator);
+        
+        // Obtain the shard of relator
+        Shard &shard = s_shards[hash & ((0x1 << s_shard_bits) - 1)];
+        
+        // Lock the shard's mutex
+        boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+        
+        // Give an empty shard its first slots
+        if(shard.m_slots.empty())
+            shard.m_slots.resize(16, 0);
+        
+        // Obtain the mask of a slot
+        std::size_t mask = shard.m_slots.size() - 1;
+        
+        // Loop over slots, starting from the one picked by the hash
+        for(std::size_t slot = (hash >> s_shard_bits) & mask; true; slot = (slot + 1) & mask)
+        {
+            // If the slot is occupied, check if it holds relator
+            if(shard.m_slots[slot])
+            {
+                // Obtain the id in the slot
+                unsigned int id = shard.m_slots[slot] - 1;
+                
+                // If the Relator with id is relator, return id
+                if(*get_relator(id) == relator)
+                    return id;
+                
+                // Continue to the next slot
+                continue;
+            }
+            
+            // The slot is empty, so relator is not in the table; add it
+            unsigned int id = add(relator);
+            
+            // Put id into the slot
+            shard.m_slots[slot] = id + 1;
+            
+            // Grow the shard if more than half its slots are occupied
+            if((2 * ++shard.m_size) > shard.m_slots.size())
+                grow(shard);
+            
+            // Return id
+            return id;
+        }
+    }
+    
+    bool Relator_table::find(const Relator &relator, unsigned int &id)
+    {
+        // Obtain the hash of relator
+        std::size_t hash = static_cast<std::size_t>(relator);
+        
+        // Obtain the shard of relator
+        Shard &shard = s_shards[hash & ((0x1 << s_shard_bits) - 1)];
+        
+        // Lock the shard's mutex
+        boost::lock_guard<boost::mutex> lock_guard(shard.m_mutex);
+        
+        // An empty shard holds no Relators
+        if(shard.m_slots.empty())
+            return false;
+        
+        // Obtain the mask of a slot
+        std::size_t mask = shard.m_slots.size() - 1;
+        
+        // Loop over occupied slots, starting from the one picked by the hash
+        for(std::size_t slot = (hash >> s_shard_bits) & mask; shard.m_slots[slot]; slot = (slot + 1) & mask)
+        {
+            // Obtain the id in the slot
+            id = shard.m_slots[slot] - 1;
+            
+            // If the Relator with id is relator, indicate it was found
+            if(*get_relator(id) == relator)
+                return true;
+        }
+        
+        // The slot is empty, so relator is not in the table
+        return false;
+    }
+    
+    void Relator_table::clear()
+    {
+        // Lock s_mutex
+        boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+        
+        // Loop over Relators, deleting each (Note: the chunks are kept)
+        for(unsigned long id = 0; id < s_size; ++id)
+            delete s_chunks[id >> s_chunk_bits][id & ((0x1 << s_chunk_bits) - 1)];
+        
+        // Loop over shards, emptying each
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> shard_lock_guard(s_shards[index].m_mutex);
+            
+            // Empty the slots, keeping them, so a refilled shard need not grow again
+            std::fill(s_shards[index].m_slots.begin(), s_shards[index].m_slots.end(), 0);
+            
+            // Reset the size
+            s_shards[index].m_size = 0;
+        }
+        
+        // Reset s_size
+        s_size = 0;
+        
+        // Reset s_length
+        s_length = 0;
+        
+        // Reset s_bytes
+        s_bytes = 0;
+    }
+    
+    void Relator_table::release()
+    {
+        // Lock s_mutex
+        boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+        
+        // Loop over chunks, deleting each (Note: the chunks are taken in order)
+        for(unsigned long chunk = 0; (chunk < (0x1ul << (32 - s_chunk_bits))) && s_chunks[chunk]; ++chunk)
+        {
+            // Delete the chunk
+            delete[] s_chunks[chunk];
+            
+            // Null out the chunk
+            s_chunks[chunk] = 0;
+        }
+        
+        // Loop over shards, releasing the slots of each
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> shard_lock_guard(s_shards[index].m_mutex);
+            
+            // Release the slots
+            std::vector<unsigned int>().swap(s_shards[index].m_slots);
+        }
+    }
+    
+    unsigned long Relator_table::get_bytes()
+    {
+        // Define a variable to hold the bytes
+        unsigned long bytes;
+        
+        // Obtain the bytes of the Relators and of their chunks, which are taken in order (Note: s_mutex is released before a shard's mutex is taken, as intern() takes them in the other order)
+        {
+            boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+            bytes = s_bytes;
+            for(unsigned long chunk = 0; (chunk < (0x1ul << (32 - s_chunk_bits))) && s_chunks[chunk]; ++chunk)
+                bytes += (0x1 << s_chunk_bits) * sizeof(Relator*);
+        }
+        
+        // Add the bytes of the slots of each shard
+        for(unsigned int index = 0; index < (0x1u << s_shard_bits); ++index)
+        {
+            // Lock the shard's mutex
+            boost::lock_guard<boost::mutex> shard_lock_guard(s_shards[index].m_mutex);
+            
+            // Add the bytes of its slots
+            bytes += s_shards[index].m_slots.capacity() * sizeof(unsigned int);
+        }
+        
+        // Return the bytes
+        return bytes;
+    }
+    
+    unsigned int Relator_table::add(const Relator &relator)
+    {
+        // Lock s_mutex
+        boost::lock_guard<boost::mutex> lock_guard(s_mutex);
+        
+        // The ids are 32 bit and stored plus one in the slots, so 0xFFFFFFFF, which would be stored as the empty 0, is never handed out
+        if(s_size >= 0xFFFFFFFF)
+            throw std::overflow_error("Relator_table: more than 2^32 - 1 Relators");
+        
+        // Obtain the next id
+        unsigned int id = static_cast<unsigned int>(s_size);
+        
+        // Obtain the chunk of id
+        Relator **&chunk = s_chunks[id >> s_chunk_bits];
+        
+        // If the chunk is not yet allocated, allocate it
+        if(!chunk)
+            chunk = new Relator*[0x1 << s_chunk_bits];
+        
+        // Store a copy of relator in the chunk (Note: may allocate)
+        Relator *copy = new Relator(relator);
+        chunk[id & ((0x1 << s_chunk_bits) - 1)] = copy;
+        
+        // Increment s_bytes
+        s_bytes += copy->get_bytes();
+        
+        // Increment s_size
+        ++s_size;
+        
+        // Increment s_length
+        s_length += relator.get_length();
+        
+        // Return id
+        return id;
+    }
+    
+    void Relator_table::grow(Shard &shard)
+    {
+        // Define the doubled slots
+        std::vector<unsigned int> slots(2 * shard.m_slots.size(), 0);
+        
+        // Obtain the mask of a slot
+        std::size_t mask = slots.size() - 1;
+        
+        // Loop over the occupied slots of the shard
+        for(std::size_t index = 0; index < shard.m_slots.size(); ++index)
+        {
+            // Skip empty slots
+            if(!shard.m_slots[index])
+                continue;
+            
+            // Obtain the hash of the Relator in the slot
+            std::size_t hash = static_cast<std::size_t>(*get_relator(shard.m_slots[index] - 1));
+            
+            // Find the first empty doubled slot, starting from the one picked by the hash
+            std::size_t slot = (hash >> s_shard_bits) & mask;
+            while(slots[slot])
+                slot = (slot + 1) & mask;
+            
+            // Put the id into the doubled slot
+            slots[slot] = shard.m_slots[index];
+        }
+        
+        // Replace the slots of the shard
+        shard.m_slots.swap(slots);
+    }
+}
@@ -0,0 +1,168 @@
+//
+//  relator_table.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_relator_table_h
+#define Andrews_Curtis_Conjecture_relator_table_h
+
+
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+
+namespace andrews_curtis
+{
+    // Forward declarations
+    class Relator;
+    
+    ///
+    /// This class encapsulates the functionality of a global, concurrent, intern
+    /// table of Relators. Each distinct Relator is stored once and is identified
+    /// by a 32 bit id, handed out in order of interning. So, two Relators are
+    /// equal if and only if their ids are equal.
+    ///
+    /// Relators are never removed from the table, except by clear(), so an id
+    /// and the Relator it identifies stay valid for the whole search, or in
+    /// fingerprinted and external mode, unless frozen, for a level.
+    ///
+    class Relator_table
+    {
+    public:
+        ///
+        /// Interns the passed Relator, returning the id of the equal Relator in
+        /// the table. If there is no such Relator, a copy of the passed Relator
+        /// is added to the table.
+        ///
+        /// \param relator The Relator to intern
+        /// \return The id of the Relator
+        ///
+        static unsigned int intern(const Relator &relator);
+        
+        ///
+        /// Finds the passed Relator in the table, without adding it if absent
+        ///
+        /// \param relator The Relator to find
+        /// \param id Set to the id of the Relator, if it is in the table
+        /// \return A bool indicating if the Relator is in the table
+        ///
+        static bool find(const Relator &relator, unsigned int &id);
+        
+        ///
+        /// Obtains the Relator with the passed id
+        ///
+        /// \param id The id of the Relator
+        /// \return The Relator with the passed id
+        ///
+        static const Relator *get_relator(unsigned int id);
+        
+        ///
+        /// Obtains the number of Relators in the table
+        ///
+        /// \return The number of Relators in the table
+        ///
+        static unsigned long size();
+        
+        ///
+        /// Obtains the sum of the lengths of the Relators in the table
+        ///
+        /// \return The sum of the lengths of the Relators in the table
+        ///
+        static unsigned long length();
+        
+        ///
+        /// Obtains the number of bytes of the table, its Relators, their chunks
+        /// and the index
+        ///
+        /// \return The number of bytes of the table
+        ///
+        static unsigned long get_bytes();
+        
+        ///
+        /// Clears the table of all Relators and calls the destructor of each.
+        /// The chunks and index are kept, to be refilled.
+        ///
+        static void clear();
+        
+        ///
+        /// Frees the chunks and index of the table, which must be clear()ed
+        ///
+        static void release();
+        
+        
+    private:
+        /// The number of bits of a hash picking the shard of a Relator
+        static const unsigned int s_shard_bits = 6;
+        
+        /// The number of bits of an id picking the Relator within its chunk
+        static const unsigned int s_chunk_bits = 16;
+        
+        ///
+        /// A shard of the table's index. Each shard is an open addressing hash
+        /// table, with linear probing, of the ids plus one of the Relators whose
+        /// hash picks the shard, 0 marking an empty slot.
+        ///
+        struct Shard
+        {
+            /// Mutex for the shard
+            boost::mutex m_mutex;
+            
+            /// The slots of the shard, a power of 2 in number
+            std::vector<unsigned int> m_slots;
+            
+            /// The number of occupied slots
+            unsigned long m_size;
+        };
+        
+        /// Note: Sharding the index by hash lets threads intern Relators in dif-
+        /// ferent shards concurrently. Only handing out an id, which is rare as
+        /// most Relators are already in the table, takes the global s_mutex.
+        
+        /// Note: The Relators are held in chunks of 2^s_chunk_bits pointers that
+        /// are never moved. So, get_relator() is two loads and takes no lock; a
+        /// Relator is stored before its id is handed out.
+        
+        /// The shards of the index
+        static Shard s_shards[0x1 << s_shard_bits];
+        
+        /// The chunks of Relators, indexed by the high bits of an id
+        static Relator **s_chunks[0x1 << (32 - s_chunk_bits)];
+        
+        /// Mutex for handing out ids
+        static boost::mutex s_mutex;
+        
+        /// The number of Relators in the table
+        static unsigned long s_size;
+        
+        /// The sum of the lengths of the Relators in the table
+        static unsigned long s_length;
+        
+        /// The sum of the bytes of the Relators in the table
+        static unsigned long s_bytes;
+        
+        
+    private:
+        //
+        // Adds a copy of the passed Relator to the chunks, returning its id
+        //
+        // \param relator The Relator to add
+        // \return The id of the added Relator
+        //
+        static unsigned int add(const Relator &relator);
+        
+        //
+        // Doubles the number of slots of the passed shard, re-inserting its ids
+        //
+        // \param shard The shard to grow
+        //
+        static void grow(Shard &shard);
+    };
+}
+
+#include "relator_table-inl.h"
+
+#endif
@@ -7,16 +7,20 @@
 //
 
 #include <list>
+#include <deque>
 #include <queue>
 #include <memory>
 #include <vector>
 #include <utility>
+#include <sstream>
 #include <iostream>
+#include <algorithm>
 #include <functional>
 
 #include <boost/bind.hpp>
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
 #include <boost/thread.hpp>
-#include <boost/scoped_array.hpp>
 #include <boost/thread/locks.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/mpi/nonblocking.hpp>
@@ -30,8 +34,15 @@
 
 #include "relator.h"
 #include "globals.h"
+#include "relator_table.h"
 #include "searcher.h"
 #include "arguments.h"
+#include "hash_set.h"
+#include "fingerprint_set.h"
+#include "bloom_filter.h"
+#include "external_store.h"
+#include "frozen_set.h"
+#include "succinct_set.h"
 #include "binary_tree.h"
 #include "boost/threadpool.hpp"
 #include "balanced_presentation.h"
@@ -49,17 +60,27 @@ static boost::mutex s_queue_mutex;
 // Queue to hold elements in the next level
 static std::queue<andrews_curtis::Balanced_presentation*> s_balanced_presentation_queue;
 
+// Queue to hold, in fingerprinted mode, the records of the elements in the next level, g_relators_count ids an element
+static std::deque<unsigned int> s_record_queue;
+
+// Number of probes in the level the Bloom_filter answered definitely new
+static boost::atomic<unsigned long> s_bloom_filter_negatives(0);
+
+// Number of probes in the level the Bloom_filter answered maybe present, that were new
+static boost::atomic<unsigned long> s_bloom_filter_false_positives(0);
+
 namespace andrews_curtis
 {
     // Typedefs
     typedef std::list<Balanced_presentation*>::iterator Itr;
+    typedef Balanced_presentation_nursery::Children Children;
   	typedef std::queue<andrews_curtis::Balanced_presentation*>::size_type queue_size_type;
 
   	// Utility function to obtain children
-  	void obtain_children(std::vector< std::list<Balanced_presentation*> > *in_values);
+  	void obtain_children(std::vector<Children> *in_values,bool *is_trivial,Balanced_presentation **trivial_presentation);
 
-  	// Utility function to clear lists
-  	void clear_list(std::list<Balanced_presentation*> *list);
+  	// Utility function to clear Children
+  	void clear_children(Children *children);
 
   	// Utility function to delete a Balanced_presentation
   	void delete_balanced_presentation(Balanced_presentation *balanced_presentation);
@@ -67,6 +88,45 @@ namespace andrews_curtis
   	// Utility function to insert Balanced presentations
   	void insert_balanced_presentation(Balanced_presentation *balanced_presentation,bool *is_trivial,Balanced_presentation **trivial_presentation);
 
+  	// Utility function to insert a child received from another process, interning its relators only if it is new
+  	void insert_child(const Children *children,std::size_t child,bool *is_trivial,Balanced_presentation **trivial_presentation);
+
+  	// Utility function to obtain the number of presentations on the queue, in fingerprinted mode the number of records
+  	queue_size_type get_queue_size();
+
+  	// Utility function to intern the relators of the records on the queue anew, emptying the Relator_table of those of the levels before
+  	void reintern_record_queue();
+
+  	// Utility function to push a new Balanced presentation, merged by the External_store, onto the queue
+  	void push_balanced_presentation(const std::vector<Relator> &relators,bool *is_trivial,Balanced_presentation **trivial_presentation);
+
+  	// Utility function to realize a derivation of canonical forms as Andrews-Curtis moves
+  	std::string realize_derivation(const Arguments &arguments,const std::string &derivation);
+
+  	// Utility function to size the Bloom_filter, refilling it from the presentations found if it grew
+  	void reserve_bloom_filter(unsigned long count);
+
+  	// Utility function to add a Balanced_presentation to the Bloom_filter
+  	void add_to_bloom_filter(const Balanced_presentation *balanced_presentation);
+
+  	// Utility function to add the fingerprint of a Balanced_presentation to the Bloom_filter
+  	void add_fingerprint_to_bloom_filter(boost::uint64_t high,boost::uint64_t low);
+
+  	// Utility function to add the presentation with the passed ids to the Bloom_filter, made in the passed scratch Balanced_presentation
+  	void add_record_to_bloom_filter(const unsigned int *relators,Balanced_presentation *scratch);
+
+  	// Utility function to freeze the presentations of the tree, a completed level, into the Frozen_set, emptying the tree
+  	void freeze_tree();
+
+  	// Utility function to append the ids of a Balanced_presentation to records, and the handle of its parent to parents
+  	void append_record(const Balanced_presentation *balanced_presentation,std::vector<unsigned int> *records,std::vector<boost::uint64_t> *parents);
+
+  	// Utility function to freeze the records on the queue, the presentations of the Fingerprint_set, a completed level, into the Succinct_set, emptying the Fingerprint_set
+  	void freeze_fingerprint_set();
+
+  	// Utility function returning a bool indicating if a Balanced_presentation is in the Frozen_set, or in fingerprinted mode the Succinct_set
+  	bool is_in_frozen_set(const Balanced_presentation *balanced_presentation);
+
 
     Searcher::Searcher(const Arguments &arguments)
     :   m_is_trivial(false),
@@ -77,38 +137,68 @@ namespace andrews_curtis
         // New up a Balanced_presentation
         std::auto_ptr<Balanced_presentation> balanced_presentation(new Balanced_presentation());
 
-        // Define array of Relator's
-        boost::scoped_array< std::auto_ptr<Relator> > relators(new std::auto_ptr<Relator>[g_relators_count]);
-
         // Loop over user relators
         for(unsigned int index = 0; index < g_relators_count; ++index)
         {
-            // New up a Relator with 'index' relator from m_arguments
-            relators[index] = std::auto_ptr<Relator>(new Relator(m_arguments.get_relators()[index]));
-
-            // Insert relator into balanced_presentation
-            balanced_presentation->set_relator(relators[index].get(), index);
+            // Define a Relator with 'index' relator from m_arguments
+            Relator relator(m_arguments.get_relators()[index]);
+            
+            // In cyclic mode, cyclically reduce the Relator and rotate it to its least rotation
+            if(g_is_cyclic)
+                relator.make_cyclic();
+
+            // Intern relator into balanced_presentation
+            balanced_presentation->set_relator(Relator_table::intern(relator), index);
         }
 
         // Set m_counterexample
         m_counterexample = "Counterexample:\n";
         m_counterexample += balanced_presentation->to_string();
+        
+        // In canonical mode, replace balanced_presentation with its canonical form
+        if(g_is_canonical)
+            balanced_presentation->canonicalize();
 
         // Define the world communicator in which we reside
         boost::mpi::communicator communicator;
 
+        // In external mode, open the External_store on every process
+        if(g_is_external)
+            External_store::open(m_arguments.get_external_directory());
+
+        // In external mode, the home of balanced_presentation adds it to the External_store, which pushes it onto the queue
+        if(g_is_external && (communicator.rank() == balanced_presentation->get_process()))
+        {
+            // Add the Balanced_presentation to the External_store
+            External_store::add(balanced_presentation.get());
+
+            // Merge it into the External_store, pushing a copy onto the queue
+            External_store::merge(boost::bind(push_balanced_presentation,_1,&m_is_trivial,&m_trivial_presentation));
+        }
         // Is this process the home of balanced_presentation?
-        if(communicator.rank() == balanced_presentation->get_process())
+        else if(!g_is_external && (communicator.rank() == balanced_presentation->get_process()))
         {
-            // Insert Relators into scapegoat tree and give up ownership
-            for(unsigned int index = 0; index < g_relators_count; ++index)
-                Binary_tree<Relator>::insert(relators[index].release());
+            // In fingerprinted mode, insert the Balanced_presentation into the Fingerprint_set and push its record onto the queue, the Balanced_presentation is deleted
+            if(g_is_fingerprinted)
+            {
+                // Insert Balanced_presentation into the Fingerprint_set
+                Fingerprint_set<Balanced_presentation>::insert(balanced_presentation.get());
 
-            // Push the Balanced_presentation onto the queue
-            s_balanced_presentation_queue.push(balanced_presentation.get());
+                // Push its record onto the queue
+                for(unsigned int index = 0; index < g_relators_count; ++index)
+                    s_record_queue.push_back(balanced_presentation->get_relator_id(index));
+            }
+            else
+            {
+                // Push the Balanced_presentation onto the queue
+                s_balanced_presentation_queue.push(balanced_presentation.get());
 
-            // Insert Balanced_presentation into scapegoat tree and give up ownership
-            Binary_tree<Balanced_presentation>::insert(balanced_presentation.release());
+                // Insert Balanced_presentation into the Hash_set or scapegoat tree and give up ownership
+                if(g_is_hashed)
+                    Hash_set<Balanced_presentation>::insert(balanced_presentation.release());
+                else
+                    Binary_tree<Balanced_presentation>::insert(balanced_presentation.release());
+            }
         }
     }
 
@@ -126,35 +216,52 @@ namespace andrews_curtis
     		// Log the number of threads in the thread pool
     		std::cout << "Process: " << communicator.rank() << " Thread pool size: " << thread_pool.size() << std::endl;
 
+        // Define variables to hold the local allocations before the current level
+        unsigned long previous_relator_allocations = 0;
+        unsigned long previous_balanced_presentation_allocations = 0;
+
+        // Define variable to hold the local number of presentations before the current level
+        unsigned long previous_balanced_presentation_size = 0;
+
         // Define vector to hold values to send
-        std::vector< std::list<Balanced_presentation*> > in_values(communicator.size());
+        std::vector<Children> in_values(communicator.size());
 
         // Define vector to hold values to receive
-        std::vector< std::list<Balanced_presentation*> > out_values(communicator.size());
+        std::vector<Children> out_values(communicator.size());
 
         // Loop forever
         while(true)
         {
-      			// Obtain length of local Relator Binary_tree
-      			unsigned long local_relator_length = Binary_tree<Relator>::length();
+      			// In hashed mode, free the tables the Hash_set outgrew in the level, no thread is probing them now
+      			if(g_is_hashed)
+      				Hash_set<Balanced_presentation>::reclaim();
+
+      			// In frozen mode, freeze the completed level, leaving the tree or Fingerprint_set to the next level
+      			if(g_is_frozen && g_is_fingerprinted)
+      				freeze_fingerprint_set();
+      			else if(g_is_frozen)
+      				freeze_tree();
 
-      			// Define a variable to hold the length of the global Relator Binary_tree
+      			// Obtain length of local Relator_table
+      			unsigned long local_relator_length = Relator_table::length();
+
+      			// Define a variable to hold the length of the global Relator_table
       			unsigned long global_relator_length;
 
       			// Obtain global Relator length
       			boost::mpi::reduce(communicator,local_relator_length,global_relator_length, std::plus<unsigned long>(),0);
 
-      			// Obtain size of local Relator Binary_tree
-      			unsigned long local_relator_size = Binary_tree<Relator>::size();
+      			// Obtain size of local Relator_table
+      			unsigned long local_relator_size = Relator_table::size();
 
-      			// Define a variable to hold the size of the global Relator Binary_tree
+      			// Define a variable to hold the size of the global Relator_table
       			unsigned long global_relator_size;
 
       			// Obtain global Relator size
       			boost::mpi::reduce(communicator,local_relator_size,global_relator_size, std::plus<unsigned long>(),0);
 
-      			// Obtain size of local Balanced_presentation Binary_tree
-      			unsigned long local_balanced_presentation_size = Binary_tree<Balanced_presentation>::size();
+      			// Obtain size of local Balanced_presentation External_store, Succinct_set, Frozen_set, Fingerprint_set, Hash_set or Binary_tree (Note: in frozen mode the tree or Fingerprint_set was just emptied)
+      			unsigned long local_balanced_presentation_size = g_is_frozen ? (g_is_fingerprinted ? Succinct_set::size() : Frozen_set::size()) : g_is_external ? External_store::size() : (g_is_fingerprinted ? Fingerprint_set<Balanced_presentation>::size() : (g_is_hashed ? Hash_set<Balanced_presentation>::size() : Binary_tree<Balanced_presentation>::size()));
 
       			// Define a variable to hold the size of the global Balanced_presentation Binary_tree
       			unsigned long global_balanced_presentation_size;
@@ -162,6 +269,100 @@ namespace andrews_curtis
       			// Obtain global Balanced_presentation size
       			boost::mpi::reduce(communicator,local_balanced_presentation_size,global_balanced_presentation_size, std::plus<unsigned long>(),0);
 
+      			// Define bool indicating if the presentations are stored in the Binary_trees
+      			bool is_tree = !g_is_hashed && !g_is_fingerprinted && !g_is_external && !g_is_frozen;
+
+      			// Obtain the height, the sum of depths and rebuilds of the local Binary_tree (Note: 0 if not in a tree)
+      			unsigned long local_tree_height = is_tree ? Binary_tree<Balanced_presentation>::height() : 0;
+      			unsigned long local_tree_depths = is_tree ? Binary_tree<Balanced_presentation>::depths() : 0;
+      			unsigned long local_tree_rebuilds = is_tree ? Binary_tree<Balanced_presentation>::rebuilds() : 0;
+
+      			// Define variables to hold the global height, sum of depths and rebuilds
+      			unsigned long global_tree_height;
+      			unsigned long global_tree_depths;
+      			unsigned long global_tree_rebuilds;
+
+      			// Obtain the global height, the greatest local height, sum of depths and rebuilds
+      			boost::mpi::reduce(communicator,local_tree_height,global_tree_height, boost::mpi::maximum<unsigned long>(),0);
+      			boost::mpi::reduce(communicator,local_tree_depths,global_tree_depths, std::plus<unsigned long>(),0);
+      			boost::mpi::reduce(communicator,local_tree_rebuilds,global_tree_rebuilds, std::plus<unsigned long>(),0);
+
+      			// Obtain the local allocations of Relators in the level
+      			unsigned long relator_allocations = Relator::get_allocations();
+      			unsigned long local_relator_allocations = relator_allocations - previous_relator_allocations;
+      			previous_relator_allocations = relator_allocations;
+
+      			// Define a variable to hold the global allocations of Relators in the level
+      			unsigned long global_relator_allocations;
+
+      			// Obtain global Relator allocations
+      			boost::mpi::reduce(communicator,local_relator_allocations,global_relator_allocations, std::plus<unsigned long>(),0);
+
+      			// Obtain the local allocations of Balanced_presentations in the level
+      			unsigned long balanced_presentation_allocations = Balanced_presentation::get_allocations();
+      			unsigned long local_balanced_presentation_allocations = balanced_presentation_allocations - previous_balanced_presentation_allocations;
+      			previous_balanced_presentation_allocations = balanced_presentation_allocations;
+
+      			// Define a variable to hold the global allocations of Balanced_presentations in the level
+      			unsigned long global_balanced_presentation_allocations;
+
+      			// Obtain global Balanced_presentation allocations
+      			boost::mpi::reduce(communicator,local_balanced_presentation_allocations,global_balanced_presentation_allocations, std::plus<unsigned long>(),0);
+
+      			// Obtain the bytes of the local Relator_table (Note: 0 unless frozen or fingerprinted, the modes printing bytes per presentation)
+      			unsigned long local_relator_table_bytes = (g_is_frozen || g_is_fingerprinted) ? Relator_table::get_bytes() : 0;
+
+      			// Define a variable to hold the bytes of the global Relator_table
+      			unsigned long global_relator_table_bytes;
+
+      			// Obtain the global bytes of the Relator_tables
+      			boost::mpi::reduce(communicator,local_relator_table_bytes,global_relator_table_bytes, std::plus<unsigned long>(),0);
+
+      			// Obtain the bytes of the local Fingerprint_set (Note: 0 if not fingerprinted)
+      			unsigned long local_fingerprint_bytes = g_is_fingerprinted ? Fingerprint_set<Balanced_presentation>::get_bytes() : 0;
+
+      			// Define a variable to hold the bytes of the global Fingerprint_set
+      			unsigned long global_fingerprint_bytes;
+
+      			// Obtain the global bytes of the Fingerprint_sets
+      			boost::mpi::reduce(communicator,local_fingerprint_bytes,global_fingerprint_bytes, std::plus<unsigned long>(),0);
+
+      			// Obtain the bytes on disk of the local External_store (Note: 0 if not external)
+      			unsigned long local_external_bytes = g_is_external ? External_store::get_bytes() : 0;
+
+      			// Define a variable to hold the bytes on disk of the global External_store
+      			unsigned long global_external_bytes;
+
+      			// Obtain the global bytes on disk
+      			boost::mpi::reduce(communicator,local_external_bytes,global_external_bytes, std::plus<unsigned long>(),0);
+
+      			// Obtain the bytes of the local Frozen_set or Succinct_set (Note: 0 if not frozen)
+      			unsigned long local_frozen_bytes = g_is_frozen ? (g_is_fingerprinted ? Succinct_set::get_bytes() : Frozen_set::get_bytes()) : 0;
+
+      			// Define a variable to hold the bytes of the global Frozen_set
+      			unsigned long global_frozen_bytes;
+
+      			// Obtain the global bytes of the Frozen_sets
+      			boost::mpi::reduce(communicator,local_frozen_bytes,global_frozen_bytes, std::plus<unsigned long>(),0);
+
+      			// Obtain the bits set and bits of the local Bloom_filter, and its answers in the level (Note: 0 if not prefiltered)
+      			unsigned long local_bloom_filter_set_bits = g_is_prefiltered ? Bloom_filter::get_set_bits() : 0;
+      			unsigned long local_bloom_filter_bits = g_is_prefiltered ? Bloom_filter::get_bits() : 0;
+      			unsigned long local_bloom_filter_negatives = s_bloom_filter_negatives.exchange(0);
+      			unsigned long local_bloom_filter_false_positives = s_bloom_filter_false_positives.exchange(0);
+
+      			// Define variables to hold the global bits set, bits, and answers of the Bloom_filters
+      			unsigned long global_bloom_filter_set_bits;
+      			unsigned long global_bloom_filter_bits;
+      			unsigned long global_bloom_filter_negatives;
+      			unsigned long global_bloom_filter_false_positives;
+
+      			// Obtain the global bits set, bits, and answers of the Bloom_filters
+      			boost::mpi::reduce(communicator,local_bloom_filter_set_bits,global_bloom_filter_set_bits, std::plus<unsigned long>(),0);
+      			boost::mpi::reduce(communicator,local_bloom_filter_bits,global_bloom_filter_bits, std::plus<unsigned long>(),0);
+      			boost::mpi::reduce(communicator,local_bloom_filter_negatives,global_bloom_filter_negatives, std::plus<unsigned long>(),0);
+      			boost::mpi::reduce(communicator,local_bloom_filter_false_positives,global_bloom_filter_false_positives, std::plus<unsigned long>(),0);
+
       			// If we are process 0
       			if(!communicator.rank())
       			{
@@ -186,6 +387,51 @@ namespace andrews_curtis
       				// Print Balanced_presentation count
       				std::cout << "\tBalanced_presentations: " << global_balanced_presentation_size << std::endl;
 
+      				// Print the allocations of the level
+      				std::cout << "\tRelator allocations: " << global_relator_allocations << std::endl;
+      				std::cout << "\tBalanced_presentation allocations: " << global_balanced_presentation_allocations << std::endl;
+
+      				// Print the bytes of the Relator_tables, which the presentations of the sets below are ids into
+      				if(g_is_fingerprinted || g_is_frozen)
+      					std::cout << "\tRelator table bytes: " << global_relator_table_bytes << std::endl;
+
+      				// Print the bytes of the Fingerprint_sets, in all and per presentation with the Relator_tables (Note: in frozen mode they only hold the level being found)
+      				if(g_is_fingerprinted && !g_is_frozen)
+      				{
+      					std::cout << "\tFingerprint set bytes: " << global_fingerprint_bytes << std::endl;
+      					std::cout << "\tFingerprint set bytes per presentation: " << (static_cast<double>(global_fingerprint_bytes + global_relator_table_bytes)/global_balanced_presentation_size) << std::endl;
+      				}
+
+      				// Print the bound on the probability that two presentations have the same fingerprint (Note: in frozen mode a bound, the Fingerprint_sets only holding a level)
+      				if(g_is_fingerprinted)
+      					std::cout << "\tFingerprint collision probability: " << Fingerprint_set<Balanced_presentation>::get_collision_probability(global_balanced_presentation_size) << std::endl;
+
+      				// Print the bytes on disk of the External_stores
+      				if(g_is_external)
+      					std::cout << "\tExternal store bytes: " << global_external_bytes << std::endl;
+
+      				// Print the bytes of the Frozen_sets or Succinct_sets, and per presentation with the Relator_tables
+      				if(g_is_frozen)
+      				{
+      					std::cout << "\tFrozen set bytes: " << global_frozen_bytes << std::endl;
+      					std::cout << "\tFrozen set bytes per presentation: " << (static_cast<double>(global_frozen_bytes + global_relator_table_bytes)/global_balanced_presentation_size) << std::endl;
+      				}
+
+      				// Print the occupancy of the Bloom_filters and the rate of probes of new presentations they did not answer definitely new
+      				if(g_is_prefiltered)
+      				{
+      					std::cout << "\tBloom filter occupancy: " << (static_cast<double>(global_bloom_filter_set_bits)/global_bloom_filter_bits) << std::endl;
+      					std::cout << "\tBloom filter false positive rate: " << (static_cast<double>(global_bloom_filter_false_positives)/std::max(global_bloom_filter_false_positives + global_bloom_filter_negatives,1ul)) << std::endl;
+      				}
+
+      				// Print the height statistics of the Binary_trees
+      				if(is_tree)
+      				{
+      					std::cout << "\tBinary_tree height: " << global_tree_height << std::endl;
+      					std::cout << "\tAverage Binary_tree depth: " << (static_cast<double>(global_tree_depths)/global_balanced_presentation_size) << std::endl;
+      					std::cout << "\tBinary_tree rebuilds: " << global_tree_rebuilds << std::endl;
+      				}
+
       				// Print Average Relator length
       				std::cout << "\tAverage Relator Length: " << (static_cast<double>(global_relator_length)/global_relator_size) << std::endl;
 
@@ -193,12 +439,19 @@ namespace andrews_curtis
       				std::cout << "\tAverage Balanced presentation Length: " << g_relators_count*(static_cast<double>(global_relator_length)/global_relator_size) << std::endl;
       			}
 
-      			// Obtain size of s_balanced_presentation_queue
-      			queue_size_type queue_size = s_balanced_presentation_queue.size();
+      			// In prefiltered mode, size the Bloom_filter for the presentations after the next level, assuming it grows as this one did
+      			if(g_is_prefiltered)
+      			{
+      				reserve_bloom_filter(static_cast<unsigned long>(static_cast<double>(local_balanced_presentation_size) * local_balanced_presentation_size / std::max(previous_balanced_presentation_size,1ul)));
+      				previous_balanced_presentation_size = local_balanced_presentation_size;
+      			}
+
+      			// Obtain size of s_balanced_presentation_queue, or in fingerprinted mode of s_record_queue
+      			queue_size_type queue_size = get_queue_size();
 
       			// Schedule tasks on thread_pool
       			for(queue_size_type index = 0; index < queue_size; ++index)
-      				thread_pool.schedule(boost::bind(obtain_children,&in_values));
+      				thread_pool.schedule(boost::bind(obtain_children,&in_values,&m_is_trivial,&m_trivial_presentation));
 
       			// Wait until all children have been obtained
       			thread_pool.wait();
@@ -212,6 +465,13 @@ namespace andrews_curtis
       				// Determine source of recieve
       				int source = (communicator.rank() - process + communicator.size()) % communicator.size();
 
+      				// Hand the children for this process over, rather than serialize them
+      				if(destinaion == communicator.rank())
+      				{
+      					out_values[source].swap(in_values[destinaion]);
+      					continue;
+      				}
+
       				// Define requests
       				boost::mpi::request requests[2];
 
@@ -224,28 +484,38 @@ namespace andrews_curtis
       				// Wait on requests
       				boost::mpi::wait_all(requests, requests + 2);
 
-      				// Delete all Balanced_presentation's in in_values[destinaion]
-      				for(Itr itr = in_values[destinaion].begin(); itr != in_values[destinaion].end(); ++itr)
-      					thread_pool.schedule(boost::bind(delete_balanced_presentation,(*itr)));
-
-              // Clear in_values[destinaion] to prevent invalid pointers hanging around
-      				thread_pool.schedule(boost::bind(clear_list,&in_values[destinaion]));
+              // Clear in_values[destinaion], returning the memory of the sent children
+      				thread_pool.schedule(boost::bind(clear_children,&in_values[destinaion]));
       			}
 
            // Loop over out_values
            for(int process = 0; process < communicator.size(); ++process)
            {
-               // Loop over elements at index
-               for(Itr itr = out_values[process].begin(); itr != out_values[process].end(); ++itr)
+               // Loop over children from process
+               for(std::size_t child = 0; child < out_values[process].size(); ++child)
                {
-      				     // Schedule a thread to insert the current element
-      					   thread_pool.schedule(boost::bind(insert_balanced_presentation,*itr,&m_is_trivial,&m_trivial_presentation));
+      				     // Schedule a thread to insert the current child
+      					   thread_pool.schedule(boost::bind(insert_child,&out_values[process],child,&m_is_trivial,&m_trivial_presentation));
                }
             }
 
       			// Wait until all elements have been inserted
       			thread_pool.wait();
 
+            // In external mode, merge the level into the External_store, pushing the new presentations onto the queue
+            if(g_is_external)
+            {
+                // Write the level out as words, then empty the Relator_table, to which nothing refers as the level's presentations are deleted
+                External_store::flush();
+                Relator_table::clear();
+
+                // Share the Relators freed with the threads, which intern the relators of the next level's children
+                Relator::share();
+
+                // Merge the level, interning the relators of the new presentations
+                External_store::merge(boost::bind(push_balanced_presentation,_1,&m_is_trivial,&m_trivial_presentation));
+            }
+
             // Define bool indicating if there exists a trivial presentation globally
             bool global_is_trivial = boost::mpi::all_reduce(communicator,m_is_trivial,std::logical_or<bool>());
 
@@ -260,7 +530,7 @@ namespace andrews_curtis
             }
 
             // Define bool indicating if there exist new local presentation's
-            bool new_local_presentations = !s_balanced_presentation_queue.empty();
+            bool new_local_presentations = (0 != get_queue_size());
 
             // Define bool indicating if there exist new global presentation's
             bool new_global_presentations = boost::mpi::all_reduce(communicator,new_local_presentations,std::logical_or<bool>());
@@ -269,9 +539,13 @@ namespace andrews_curtis
             if(!new_global_presentations)
               break;
 
-             // Clear out_values to prevent invalid pointers hanging around
+            // In fingerprinted mode, intern the relators of the next level anew, so the Relator_table only holds those (Note: the fingerprints are of words, so do not refer to it; in frozen mode the records of the Succinct_set do, so it is kept)
+            if(g_is_fingerprinted && !g_is_frozen)
+                reintern_record_queue();
+
+             // Clear out_values, returning the memory of the received children
              for(unsigned int index = 0; index < out_values.size(); ++index)
-      			 	 thread_pool.schedule(boost::bind(clear_list,&out_values[index]));
+      			 	 thread_pool.schedule(boost::bind(clear_children,&out_values[index]));
 
       			// Wait until all lists have been cleared
       			thread_pool.wait();
@@ -294,6 +568,23 @@ namespace andrews_curtis
         // Set current Balanced_presentation
         const Balanced_presentation *bp = m_trivial_presentation;
 
+        // In fingerprinted and external mode the parents are not kept, so only print the trivial presentation
+        if(g_is_fingerprinted || g_is_external)
+        {
+            // If the trivial presentation lives on this process, print it
+            if(bp)
+            {
+                std::cout << std::endl << "Derivation not kept in " << (g_is_external ? "external" : "fingerprinted") << " mode, trivial presentation:" << std::endl;
+                std::cout << bp->to_string();
+            }
+
+            // Return to caller
+            return;
+        }
+
+        // In frozen mode, define the Balanced_presentation the parents are made in from the Frozen_set (Note: new'd, as its ids follow it)
+        std::auto_ptr<Balanced_presentation> frozen(g_is_frozen ? new Balanced_presentation() : 0);
+
         // Loop forever
         while(true)
         {
@@ -301,10 +592,10 @@ namespace andrews_curtis
             bool done = false;
 
             // Define vector to hold values to send
-            std::vector< std::pair<const Balanced_presentation*,std::string> > in_values(communicator.size());
+            std::vector< std::pair<boost::uint64_t,std::string> > in_values(communicator.size());
 
             // Define vector to hold values to receive
-            std::vector< std::pair<const Balanced_presentation*,std::string> > out_values(communicator.size());
+            std::vector< std::pair<boost::uint64_t,std::string> > out_values(communicator.size());
 
             // If bp is not null
             if(bp)
@@ -313,16 +604,20 @@ namespace andrews_curtis
 				        derivation = bp->to_string() + derivation;
 
                 // If there is a parent to bp
-                if(bp->get_parent())
+                if(bp->has_parent())
                 {
-                    // Add bp to in_values
-                    in_values[bp->get_parent_process()] = std::pair<const Balanced_presentation*,std::string>(bp,derivation);
+                    // Add the handle of the parent of bp to in_values
+                    in_values[bp->get_parent_process()] = std::pair<boost::uint64_t,std::string>(bp->get_parent_handle(),derivation);
                 }
                 else
                 {
                     // Indicate we are done
                     done = true;
 
+                    // In canonical mode, replace the canonical forms with Andrews-Curtis moves
+                    if(g_is_canonical)
+                        derivation = realize_derivation(m_arguments,derivation);
+
           					// Print out the derivation
           					std::cout << std::endl << "Derivation:" << std::endl;
 
@@ -347,16 +642,18 @@ namespace andrews_curtis
                 // If out_values[process] is not null
                 if(out_values[process].first)
                 {
-                    // Set bp to the parent of the last printed bp
-                    bp = out_values[process].first->get_parent();
+                    // Set bp to the parent of the last printed bp, in frozen mode made from the Frozen_set
+                    if(g_is_frozen)
+                    {
+                        Frozen_set::get(static_cast<boost::uint32_t>(out_values[process].first),frozen.get());
+                        bp = frozen.get();
+                    }
+                    else
+                        bp = Balanced_presentation::get_handled(out_values[process].first);
 
                     // Set derivation to the current derivation
                     derivation = out_values[process].second;
 
-                    // Delete out_values[process].first, newed up in all_to_all
-                    if(communicator.rank() != out_values[process].first->get_process())
-                        delete out_values[process].first;
-
                     // Break out of for, a child has only one parent
                     break;
                 }
@@ -364,87 +661,234 @@ namespace andrews_curtis
         }
     }
 
-  	void obtain_children(std::vector< std::list<Balanced_presentation*> > *in_values)
+  	void obtain_children(std::vector<Children> *in_values,bool *is_trivial,Balanced_presentation **trivial_presentation)
   	{
-  		// Define Balanced_presentation
-  		Balanced_presentation *parent = 0;
+  		// Define Balanced_presentation, in fingerprinted mode made from the next record
+  		Balanced_presentation *parent = g_is_fingerprinted ? new Balanced_presentation() : 0;
 
   		// Define scope for queue lock
   		{
   			// Lock s_queue_mutex
   			boost::lock_guard<boost::mutex> lock_guard(s_queue_mutex);
 
-  			// Obtain the next Balanced_presentation
-  			parent = s_balanced_presentation_queue.front();
-
-  			// Pop balanced_presentation
-  			s_balanced_presentation_queue.pop();
+  			// In fingerprinted mode, obtain the ids of the next record and pop them
+  			if(g_is_fingerprinted)
+  			{
+  				for(unsigned int index = 0; index < g_relators_count; ++index)
+  				{
+  					parent->set_relator(s_record_queue.front(),index);
+  					s_record_queue.pop_front();
+  				}
+  			}
+  			// Otherwise, obtain the next Balanced_presentation and pop it
+  			else
+  			{
+  				parent = s_balanced_presentation_queue.front();
+  				s_balanced_presentation_queue.pop();
+  			}
   		}
 
-  		// Obtain children of parent
-  		std::list<Balanced_presentation*> children = Balanced_presentation_nursery::get_children(parent);
+  		// Note: A child is parent plus a Move. Outside of cyclic and canonical
+  		//       mode, the hash of the relator a Move makes, and so the process
+  		//       of the child, follows from the cached hashes of parent. So, a
+  		//       child is only made, i.e. newed up and its relator interned, if
+  		//       it is new to this process. As a level's tasks pop only the
+  		//       level's presentations off the queue new local children are
+  		//       inserted here, skipping the all to all. A child sent to another
+  		//       process is made as the words of its relators, see Children, and
+  		//       only interned by that process, if it is new there.
+
+  		// Obtain the Moves to the children of parent
+  		std::vector<Balanced_presentation_nursery::Move> moves;
+  		Balanced_presentation_nursery::get_moves(parent,g_is_canonical,moves);
+
+  		// Define bool indicating if the processes of children follow from the Moves
+  		bool is_lazy = !g_is_cyclic && !g_is_canonical;
 
-  		// Loop over children
-  		for(Itr itr = children.begin(); itr != children.end(); ++itr)
+  		// Define the world communicator in which we reside
+  		boost::mpi::communicator communicator;
+
+  		// Obtain the process on which parent, and the local children, live
+  		unsigned int process = communicator.rank();
+
+  		// Define the scratch Relators moves are made in
+  		Relator relator;
+  		Relator scratch;
+
+  		// Define the scratch Relators the children sent to other processes are made in
+  		std::vector<Relator> relators;
+
+  		// Obtain the handle of parent, by which its children refer to it (Note: in frozen mode parent is deleted once expanded, so its handle is its frozen index)
+  		boost::uint64_t handle = (g_is_frozen && !g_is_fingerprinted) ? ((static_cast<boost::uint64_t>(process) << 32) | Frozen_set::find(parent)) : parent->get_handle(process);
+
+  		// Define a Balanced_presentation to probe the tree with (Note: new'd, as its ids follow it)
+  		std::auto_ptr<Balanced_presentation> probe(new Balanced_presentation());
+
+  		// Define the answers of the Bloom_filter to the probes of new children
+  		unsigned long bloom_filter_negatives = 0;
+  		unsigned long bloom_filter_false_positives = 0;
+
+  		// Loop over moves
+  		for(std::vector<Balanced_presentation_nursery::Move>::const_iterator itr = moves.begin(); itr != moves.end(); ++itr)
   		{
+  			// Obtain the index of the relator changed by the move
+  			unsigned int index = itr->m_index;
+
+  			// If the child lives on this process, only make it if it is new
+  			if(is_lazy && (process == parent->get_child_process(index,Balanced_presentation_nursery::get_hash(parent,*itr))))
+  			{
+  				// Make the relator changed by the move
+  				Balanced_presentation_nursery::make_relator(parent,*itr,relator,scratch);
+
+  				// Define the id of the relator
+  				unsigned int id;
+
+  				// Define the fingerprint of the child, obtained in fingerprinted and prefiltered mode, not making it
+  				boost::uint64_t high = 0, low = 0;
+  				if(g_is_fingerprinted || g_is_prefiltered)
+  					parent->get_child_fingerprint(index,relator,high,low);
+
+  				// Define bool indicating if the Bloom_filter answered the child definitely new
+  				bool is_new = g_is_prefiltered && !Bloom_filter::contains(high,low);
+
+  				// In prefiltered mode, if the child is definitely new, skip probing the Relator_table and the Fingerprint_set, Hash_set or tree
+  				if(is_new)
+  				{
+  					// Count the answer
+  					++bloom_filter_negatives;
+
+  					// Intern the relator
+  					id = Relator_table::intern(relator);
+  				}
+  				// In fingerprinted mode, probe the Fingerprint_set with the fingerprint of the child (Note: the Relator_table only holds the relators of the levels in memory, so an interned relator does not tell)
+  				else if(g_is_fingerprinted)
+  				{
+  					// If the child is in the Fingerprint_set, skip it
+  					if(Fingerprint_set<Balanced_presentation>::find(high,low))
+  						continue;
+
+  					// Otherwise the child is new to the level, intern the relator
+  					id = Relator_table::intern(relator);
+
+  					// In frozen mode the child may be in the Succinct_set, of the completed levels (Note: a relator just interned has an id no record there has, and the Succinct_set is not changed in a level, so takes no lock)
+  					if(g_is_frozen)
+  					{
+  						// Make probe the child
+  						probe->make_child_of(*parent,process);
+  						probe->set_relator(id,index);
+
+  						// If the child is in the Succinct_set, skip it
+  						if(Succinct_set::contains(probe.get()))
+  							continue;
+  					}
+  				}
+  				// If the relator is already interned the child may be in the tree (Note: in external mode there is no tree to probe)
+  				else if(!g_is_external && Relator_table::find(relator,id))
+  				{
+  					// Make probe the child
+  					probe->make_child_of(*parent,process);
+  					probe->set_relator(id,index);
+
+  					// If the child is in the Frozen_set, Hash_set or tree, skip it (Note: the Frozen_set is not changed in a level, so takes no lock)
+  					if((g_is_frozen && Frozen_set::contains(probe.get())) || (g_is_hashed ? Hash_set<Balanced_presentation>::find(probe.get()) : Binary_tree<Balanced_presentation>::find(probe.get())))
+  						continue;
+  				}
+  				// Otherwise the child is new, or in external mode may be, intern the relator
+  				else
+  					id = Relator_table::intern(relator);
+
+  				// In prefiltered mode, if the Bloom_filter did not answer the new child definitely new, it gave a false positive
+  				if(g_is_prefiltered && !is_new)
+  					++bloom_filter_false_positives;
+
+  				// New up the child
+  				Balanced_presentation *child = new Balanced_presentation();
+  				child->make_child_of(*parent,process);
+  				child->set_parent(handle);
+  				child->set_relator(id,index);
+
+  				// Insert the child, it may have been inserted since it was probed for
+  				insert_balanced_presentation(child,is_trivial,trivial_presentation);
+
+  				// Continue to the next move
+  				continue;
+  			}
+
+  			// Make the relators of the child, not interning them
+  			Balanced_presentation_nursery::make_relators(parent,*itr,relators,scratch);
+
+  			// In canonical mode, replace the child with its canonical form before routing it
+  			if(g_is_canonical)
+  				Balanced_presentation::canonicalize(relators);
+
   			// Lock s_in_values_mutex
   			boost::lock_guard<boost::mutex> lock_guard(s_in_values_mutex);
 
   			// Place children in apropos place in in_values
-  			(*in_values)[(*itr)->get_process()].push_back((*itr));
+  			(*in_values)[Balanced_presentation::get_process(relators)].push_back(relators,handle);
+  		}
+
+  		// In fingerprinted, external and frozen mode parent is only a fingerprint or record once its children are made, so delete it
+  		if(g_is_fingerprinted || g_is_external || g_is_frozen)
+  			delete parent;
+
+  		// Add the answers of the Bloom_filter, once per task
+  		if(g_is_prefiltered)
+  		{
+  			s_bloom_filter_negatives.fetch_add(bloom_filter_negatives,boost::memory_order_relaxed);
+  			s_bloom_filter_false_positives.fetch_add(bloom_filter_false_positives,boost::memory_order_relaxed);
   		}
   	}
 
-  	void clear_list(std::list<Balanced_presentation*> *list)
+  	void clear_children(Children *children)
   	{
-  		list->clear();
+  		children->clear();
   	}
 
   	void delete_balanced_presentation(Balanced_presentation *balanced_presentation)
   	{
-  		// Delete Relators
-  		for(unsigned int relator = 0; relator < g_relators_count; ++relator)
-  			delete balanced_presentation->get_relator(relator);
-
-  		// Delete Balanced_presentation
+  		// Delete Balanced_presentation (Note: its Relators are in the Relator_table)
   		delete balanced_presentation;
   	}
 
   	void insert_balanced_presentation(Balanced_presentation *balanced_presentation,bool *is_trivial,Balanced_presentation **trivial_presentation)
   	{
-  		// Attempt to insert balanced_presentation into the tree
-  		Balanced_presentation *bp = Binary_tree<Balanced_presentation>::insert(balanced_presentation);
-
-  		// If insertion worked, i.e. if balanced_presentation was not previously in the tree
-  		if(!bp)
+  		// In external mode, add balanced_presentation to the External_store, its duplicates are found once the level is merged
+  		if(g_is_external)
   		{
-  			// Loop over Relators
-  			for(unsigned int relator = 0; relator < g_relators_count; ++relator)
-  			{
-  				// Attempt to insert relator into the tree
-  				Relator *rel = Binary_tree<Relator>::insert(balanced_presentation->get_relator(relator));
+  			// Add balanced_presentation to the External_store
+  			External_store::add(balanced_presentation);
 
-  				// If insertion did not work, i.e. if the rel was previously in the tree
-  				if(rel)
-  				{
-  					// Lock m_mutex as we are modifying balanced_presentation which is in the tree
-  					boost::lock_guard<boost::mutex> lock_guard(Binary_tree<Balanced_presentation>::m_mutex);
+  			// Delete the Balanced_presentation balanced_presentation (Note: its Relators are in the Relator_table)
+  			delete balanced_presentation;
 
-  					// Delete the current relator
-  					delete balanced_presentation->get_relator(relator);
+  			// Return to caller
+  			return;
+  		}
 
-  					// Replace it with rel, saving memory
-  					balanced_presentation->set_relator(rel,relator);
-  				}
-  			}
+  		// Attempt to insert balanced_presentation into the Fingerprint_set, Hash_set or tree, unless in the Frozen_set or Succinct_set (Note: the Hash_set and frozen sets take no lock)
+  		bool is_present = (g_is_frozen && is_in_frozen_set(balanced_presentation)) || (g_is_fingerprinted ? Fingerprint_set<Balanced_presentation>::insert(balanced_presentation) : (0 != (g_is_hashed ? Hash_set<Balanced_presentation>::insert(balanced_presentation) : Binary_tree<Balanced_presentation>::insert(balanced_presentation))));
+
+  		// If insertion worked, i.e. if balanced_presentation was not previously in the tree
+  		if(!is_present)
+  		{
+  			// In prefiltered mode, add balanced_presentation to the Bloom_filter
+  			if(g_is_prefiltered)
+  				add_to_bloom_filter(balanced_presentation);
 
   			// Define scope for queue lock
   			{
   				// Lock s_queue_mutex
   				boost::lock_guard<boost::mutex> lock_guard(s_queue_mutex);
 
-  				// Push the balanced_presentation onto the queue
-  				s_balanced_presentation_queue.push(balanced_presentation);
+  				// Push the balanced_presentation onto the queue, in fingerprinted mode its record
+  				if(g_is_fingerprinted)
+  				{
+  					for(unsigned int index = 0; index < g_relators_count; ++index)
+  						s_record_queue.push_back(balanced_presentation->get_relator_id(index));
+  				}
+  				else
+  					s_balanced_presentation_queue.push(balanced_presentation);
   			}
 
   			// Save pointer to first trivial presentation found
@@ -453,16 +897,382 @@ namespace andrews_curtis
 
   			// Flip m_is_trivial (TODO: Remove this CPU sink)
   			(*is_trivial) = (*is_trivial) || balanced_presentation->is_trivial();
+
+  			// In fingerprinted mode the record was pushed, so delete balanced_presentation, unless it is kept as the trivial presentation
+  			if(g_is_fingerprinted && (balanced_presentation != (*trivial_presentation)))
+  				delete balanced_presentation;
   		}
   		// If insertion did not work, i.e. if balanced_presentation was previously in the tree
   		else
   		{
-  			// Delete Relators
+  			// Delete the Balanced_presentation balanced_presentation (Note: its Relators are in the Relator_table)
+  			delete balanced_presentation;
+  		}
+  	}
+
+  	void insert_child(const Children *children,std::size_t child,bool *is_trivial,Balanced_presentation **trivial_presentation)
+  	{
+  		// Note: A Relator not in the Relator_table is in no presentation found
+  		//       on this process; so, interning a Relator of the child only adds
+  		//       it to the Relator_table if the child is new, and so inserted.
+  		//       In fingerprinted mode the Relator_table only holds the relators
+  		//       of the levels in memory, so the child is first looked up by the
+  		//       fingerprint of its words, unless the Bloom_filter answers it is
+  		//       definitely new. In the other modes the only lookup is that the
+  		//       insertion into the Hash_set or tree makes, which no answer of
+  		//       the Bloom_filter can skip, so it is not consulted.
+
+  		// In fingerprinted mode, if the child is in the Fingerprint_set, skip it without interning its relators
+  		if(g_is_fingerprinted)
+  		{
+  			// Obtain the fingerprint of the child
+  			boost::uint64_t high, low;
+  			children->get_fingerprint(child,high,low);
+
+  			// In prefiltered mode, if the child is definitely new, skip probing the Fingerprint_set
+  			if(g_is_prefiltered && !Bloom_filter::contains(high,low))
+  				s_bloom_filter_negatives.fetch_add(1,boost::memory_order_relaxed);
+  			// If the child is in the Fingerprint_set, skip it
+  			else if(Fingerprint_set<Balanced_presentation>::find(high,low))
+  				return;
+  			// Otherwise, in prefiltered mode, the Bloom_filter gave a false positive
+  			else if(g_is_prefiltered)
+  				s_bloom_filter_false_positives.fetch_add(1,boost::memory_order_relaxed);
+  		}
+
+  		// New up the child
+  		Balanced_presentation *balanced_presentation = new Balanced_presentation();
+
+  		// Intern the Relators of the child
+  		for(unsigned int index = 0; index < g_relators_count; ++index)
+  			balanced_presentation->set_relator(Relator_table::intern(children->m_relators[child * g_relators_count + index]),index);
+
+  		// Set the parent of the child, on the process that sent it
+  		balanced_presentation->set_parent(children->m_parents[child]);
+
+  		// Insert the child
+  		insert_balanced_presentation(balanced_presentation,is_trivial,trivial_presentation);
+  	}
+
+  	queue_size_type get_queue_size()
+  	{
+  		return g_is_fingerprinted ? (s_record_queue.size() / g_relators_count) : s_balanced_presentation_queue.size();
+  	}
+
+  	void reintern_record_queue()
+  	{
+  		// Note: Only the records of the next level refer to the Relator_table,
+  		//       the fingerprints of the presentations found are of words. So,
+  		//       the ids of the records are numbered by first use and, if some
+  		//       Relator is no longer used, the used Relators are copied, the
+  		//       Relator_table is emptied and the copies interned in turn, each
+  		//       so given the id it was numbered with. The Relator_table then
+  		//       only holds the relators of the next level.
+
+  		// Define the number of each id of the records, ~0 until numbered
+  		std::vector<unsigned int> numbers(Relator_table::size(),~0u);
+
+  		// Define the id of each number, in order of number
+  		std::vector<unsigned int> ids;
+
+  		// Number the ids of the records by first use
+  		for(std::deque<unsigned int>::const_iterator itr = s_record_queue.begin(); itr != s_record_queue.end(); ++itr)
+  		{
+  			if(~0u == numbers[*itr])
+  			{
+  				numbers[*itr] = static_cast<unsigned int>(ids.size());
+  				ids.push_back(*itr);
+  			}
+  		}
+
+  		// If every Relator is still used, there is nothing to free
+  		if(ids.size() == numbers.size())
+  			return;
+
+  		// Define the copies of the used Relators, in order of number
+  		std::deque<Relator> relators;
+  		for(std::vector<unsigned int>::const_iterator itr = ids.begin(); itr != ids.end(); ++itr)
+  			relators.push_back(*Relator_table::get_relator(*itr));
+
+  		// Replace each id of the records with its number
+  		for(std::deque<unsigned int>::iterator itr = s_record_queue.begin(); itr != s_record_queue.end(); ++itr)
+  			*itr = numbers[*itr];
+
+  		// Empty the Relator_table of the Relators of every level
+  		Relator_table::clear();
+
+  		// Intern the copies in order, so each is given its number as its id
+  		for(std::deque<Relator>::const_iterator itr = relators.begin(); itr != relators.end(); ++itr)
+  			Relator_table::intern(*itr);
+  	}
+
+  	void push_balanced_presentation(const std::vector<Relator> &relators,bool *is_trivial,Balanced_presentation **trivial_presentation)
+  	{
+  		// New up the Balanced_presentation with the merged relators, interning them
+  		Balanced_presentation *balanced_presentation = new Balanced_presentation();
+  		for(unsigned int index = 0; index < g_relators_count; ++index)
+  			balanced_presentation->set_relator(Relator_table::intern(relators[index]),index);
+
+  		// Push the balanced_presentation onto the queue (Note: the merge is on one thread, so takes no lock)
+  		s_balanced_presentation_queue.push(balanced_presentation);
+
+  		// Save pointer to first trivial presentation found
+  		if(!(*is_trivial) && balanced_presentation->is_trivial())
+  			(*trivial_presentation) = balanced_presentation;
+
+  		// Flip m_is_trivial
+  		(*is_trivial) = (*is_trivial) || balanced_presentation->is_trivial();
+  	}
+
+  	void reserve_bloom_filter(unsigned long count)
+  	{
+  		// Size the Bloom_filter, if it was not emptied there is nothing more to do
+  		if(!Bloom_filter::reserve(count))
+  			return;
+
+  		// Refill the Bloom_filter from the Succinct_set, Frozen_set, Fingerprint_set, Hash_set or tree (Note: no thread is inserting, in frozen mode the tree or Fingerprint_set was just emptied)
+  		if(g_is_frozen)
+  		{
+  			std::auto_ptr<Balanced_presentation> scratch(new Balanced_presentation());
+  			boost::function<void (const unsigned int*)> add_record(boost::bind(add_record_to_bloom_filter,_1,scratch.get()));
+  			if(g_is_fingerprinted)
+  				Succinct_set::for_each(add_record);
+  			else
+  				Frozen_set::for_each(add_record);
+  		}
+  		else if(g_is_fingerprinted)
+  			Fingerprint_set<Balanced_presentation>::for_each(add_fingerprint_to_bloom_filter);
+  		else if(g_is_hashed)
+  			Hash_set<Balanced_presentation>::for_each(add_to_bloom_filter);
+  		else
+  			Binary_tree<Balanced_presentation>::for_each(add_to_bloom_filter);
+  	}
+
+  	void add_to_bloom_filter(const Balanced_presentation *balanced_presentation)
+  	{
+  		// Obtain the fingerprint of balanced_presentation
+  		boost::uint64_t high, low;
+  		balanced_presentation->get_fingerprint(high,low);
+
+  		// Add it to the Bloom_filter
+  		Bloom_filter::add(high,low);
+  	}
+
+  	void add_fingerprint_to_bloom_filter(boost::uint64_t high,boost::uint64_t low)
+  	{
+  		Bloom_filter::add(high,low);
+  	}
+
+  	void add_record_to_bloom_filter(const unsigned int *relators,Balanced_presentation *scratch)
+  	{
+  		// Make scratch the presentation with the ids relators
+  		for(unsigned int index = 0; index < g_relators_count; ++index)
+  			scratch->set_relator(relators[index],index);
+
+  		// Add it to the Bloom_filter
+  		add_to_bloom_filter(scratch);
+  	}
+
+  	void freeze_tree()
+  	{
+  		// Define the records of the presentations of the tree, and the handles of their parents
+  		std::vector<unsigned int> records;
+  		records.reserve(Binary_tree<Balanced_presentation>::size() * g_relators_count);
+  		std::vector<boost::uint64_t> parents;
+  		parents.reserve(Binary_tree<Balanced_presentation>::size());
+
+  		// Append the ids and parent of each presentation of the tree (Note: no thread is inserting)
+  		boost::function<void (const Balanced_presentation*)> append(boost::bind(append_record,_1,&records,&parents));
+  		Binary_tree<Balanced_presentation>::for_each(append);
+
+  		// Empty the tree, its presentations are on the queue, to be deleted once expanded
+  		Binary_tree<Balanced_presentation>::detach();
+
+  		// Freeze the records, with their parents
+  		Frozen_set::freeze(records,parents);
+  	}
+
+  	void append_record(const Balanced_presentation *balanced_presentation,std::vector<unsigned int> *records,std::vector<boost::uint64_t> *parents)
+  	{
+  		for(unsigned int index = 0; index < g_relators_count; ++index)
+  			records->push_back(balanced_presentation->get_relator_id(index));
+  		parents->push_back(balanced_presentation->get_parent_handle());
+  	}
+
+  	void freeze_fingerprint_set()
+  	{
+  		// Empty the Fingerprint_set, before its records are copied (Note: it only holds the completed level, whose records are on the queue)
+  		Fingerprint_set<Balanced_presentation>::clear();
+
+  		// Define the records of the completed level, copied from the queue, which still expands them
+  		std::vector<unsigned int> records(s_record_queue.begin(),s_record_queue.end());
+
+  		// Freeze the records
+  		Succinct_set::freeze(records);
+  	}
+
+  	bool is_in_frozen_set(const Balanced_presentation *balanced_presentation)
+  	{
+  		return g_is_fingerprinted ? Succinct_set::contains(balanced_presentation) : Frozen_set::contains(balanced_presentation);
+  	}
+
+  	std::string realize_derivation(const Arguments &arguments,const std::string &derivation)
+  	{
+  		// Note: Each line of derivation is the canonical form of a child of the
+  		//       previous line. As reordering, inverting and relabeling map moves
+  		//       to moves, a child of the previous realized presentation, after
+  		//       inverting some of its relators, has the canonical form of the
+  		//       line. So, the realized derivation is found by searching these.
+
+  		// Define the current presentation, starting from the user's presentation
+  		Balanced_presentation *current = new Balanced_presentation();
+
+  		// Define the canonical presentation of the current line
+  		Balanced_presentation *canonical = new Balanced_presentation();
+
+  		// Define a presentation to canonicalize children in
+  		Balanced_presentation *scratch = new Balanced_presentation();
+
+  		// Set current to the user's presentation, as in the Searcher constructor
+  		for(unsigned int relator = 0; relator < g_relators_count; ++relator)
+  		{
+  			// Define a Relator with the user's relator
+  			Relator user_relator(arguments.get_relators()[relator]);
+
+  			// In cyclic mode, cyclically reduce the Relator and rotate it to its least rotation
+  			if(g_is_cyclic)
+  				user_relator.make_cyclic();
+
+  			// Intern the Relator into current
+  			current->set_relator(Relator_table::intern(user_relator),relator);
+  		}
+
+  		// Start the realized derivation with the user's presentation
+  		std::string realized = current->to_string();
+
+  		// Define the lines of the derivation
+  		std::istringstream lines(derivation);
+
+  		// Define the current line
+  		std::string line;
+
+  		// Skip the first line, the canonical form of the user's presentation
+  		std::getline(lines,line);
+
+  		// Loop over the remaining lines
+  		while(std::getline(lines,line))
+  		{
+  			// Strip the "(" and ")" surrounding the relators
+  			std::string relators = line.substr(1,line.size() - 2) + ", ";
+
+  			// Parse the relators of the line, separated by ", "
   			for(unsigned int relator = 0; relator < g_relators_count; ++relator)
-  				delete balanced_presentation->get_relator(relator);
+  			{
+  				// Obtain the end of the relator
+  				std::string::size_type end = relators.find(", ");
 
-  			// Delete the Balanced_presentation balanced_presentation
-  			delete balanced_presentation;
+  				// Intern the relator into canonical
+  				canonical->set_relator(Relator_table::intern(Relator(relators.substr(0,end).c_str())),relator);
+
+  				// Drop the relator
+  				relators.erase(0,end + 2);
+  			}
+
+  			// Define bool to indicate if the line is realized
+  			bool is_realized = false;
+
+  			// Loop over the number of relators to invert, trying fewer inversions first
+  			for(unsigned int inversions = 0; !is_realized && (inversions <= g_relators_count); ++inversions)
+  			{
+  				// Loop over the sets of relators to invert
+  				for(unsigned int inverted = 0; !is_realized && (inverted < (0x1u << g_relators_count)); ++inverted)
+  				{
+  					// Only try the sets with the current number of inversions
+  					if(inversions != static_cast<unsigned int>(__builtin_popcount(inverted)))
+  						continue;
+
+  					// Define a presentation to invert relators in
+  					Balanced_presentation *inverse = new Balanced_presentation();
+
+  					// Copy current to inverse
+  					*inverse = *current;
+
+  					// Define the moves inverting relators
+  					std::string inverse_moves;
+
+  					// Invert the relators in inverted, one move at a time
+  					for(unsigned int relator = 0; relator < g_relators_count; ++relator)
+  					{
+  						// Only invert the relators in inverted
+  						if(!((inverted >> relator) & 0x1))
+  							continue;
+
+  						// Copy the Relator
+  						Relator inverse_relator(*inverse->get_relator(relator));
+
+  						// Invert the Relator
+  						inverse_relator.invert();
+
+  						// In cyclic mode, rotate the inverse to its least rotation
+  						if(g_is_cyclic)
+  							inverse_relator.make_cyclic();
+
+  						// Intern the inverse into inverse
+  						inverse->set_relator(Relator_table::intern(inverse_relator),relator);
+
+  						// Add the move
+  						inverse_moves += inverse->to_string();
+  					}
+
+  					// Obtain the children of inverse
+  					std::list<Balanced_presentation*> children = Balanced_presentation_nursery::get_children(inverse);
+
+  					// Loop over children
+  					for(Itr itr = children.begin(); itr != children.end(); ++itr)
+  					{
+  						// Canonicalize a copy of the child
+  						*scratch = *(*itr);
+  						scratch->canonicalize();
+
+  						// If the child has the canonical form of the line, it realizes the line
+  						if(!is_realized && (*scratch == *canonical))
+  						{
+  							// Flag the line as realized
+  							is_realized = true;
+
+  							// Add the moves
+  							realized += inverse_moves + (*itr)->to_string();
+
+  							// Set current to the child
+  							*current = *(*itr);
+  						}
+
+  						// Delete the child
+  						delete_balanced_presentation(*itr);
+  					}
+
+  					// Delete inverse
+  					delete_balanced_presentation(inverse);
+  				}
+  			}
+
+  			// If the line is not realized, no move reaches it, so report it and stop realizing rather than print a step that is no move
+  			if(!is_realized)
+  			{
+  				// Add the error
+  				realized += "Error: no Andrews-Curtis move realizes the canonical form " + line + "\n";
+
+  				// Stop realizing
+  				break;
+  			}
   		}
+
+  		// Delete the presentations
+  		delete_balanced_presentation(current);
+  		delete_balanced_presentation(canonical);
+  		delete_balanced_presentation(scratch);
+
+  		// Return the realized derivation
+  		return realized;
   	}
 }
@@ -0,0 +1,124 @@
+//
+//  slab_allocator-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_slab_allocator_inl_h
+#define Andrews_Curtis_Conjecture_slab_allocator_inl_h
+
+
+#include <boost/thread/lock_guard.hpp>
+
+
+namespace andrews_curtis
+{
+    inline Slab_allocator::Cache *Slab_allocator::get_cache()
+    {
+        // Obtain the cache of the calling thread
+        Cache *cache = m_cache.get();
+        
+        // If the calling thread has no cache, create it
+        if(!cache)
+        {
+            // New up the cache, empty
+            cache = new Cache();
+            cache->m_free = 0;
+            cache->m_next = 0;
+            cache->m_end = 0;
+            cache->m_allocations = 0;
+            
+            // Define scope for the lock
+            {
+                // Lock m_mutex
+                boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+                
+                // Register the cache
+                m_caches.push_back(cache);
+            }
+            
+            // Make it the cache of the calling thread
+            m_cache.reset(cache);
+        }
+        
+        // Return the cache
+        return cache;
+    }
+    
+    inline unsigned int Slab_allocator::get_index(const void *object) const
+    {
+        // Obtain the slab of object, the slabs are aligned to their size
+        const char *slab = reinterpret_cast<const char*>(reinterpret_cast<std::size_t>(object) & ~(m_slab_size - 1));
+        
+        // Obtain the number of the slab, held at its start
+        unsigned int number = *reinterpret_cast<const unsigned int*>(slab);
+        
+        // Obtain the number of object in the slab, the objects follow the slab number
+        unsigned int position = static_cast<unsigned int>((static_cast<const char*>(object) - slab - s_index_header_size) / m_size);
+        
+        // Return the index, the slab number in the high bits and the position in the low
+        return (number << m_index_bits) | position;
+    }
+    
+    inline void *Slab_allocator::get_object(unsigned int index) const
+    {
+        // Obtain the slab of the object
+        char *slab = m_numbered_slabs[index >> m_index_bits];
+        
+        // Return the object at its position in the slab
+        return slab + s_index_header_size + (index & ((0x1u << m_index_bits) - 1)) * m_size;
+    }
+    
+    inline void *Slab_allocator::allocate()
+    {
+        // Obtain the cache of the calling thread
+        Cache *cache = get_cache();
+        
+        // Count the allocation
+        ++cache->m_allocations;
+        
+        // If there is no free object and the current slab is used up, take shared free objects, if any
+        if(!cache->m_free && (static_cast<std::size_t>(cache->m_end - cache->m_next) < m_size))
+            take_shared(cache);
+        
+        // If there is a free object, reuse it
+        if(cache->m_free)
+        {
+            // Pop the first free object
+            void *object = cache->m_free;
+            cache->m_free = *static_cast<void**>(object);
+            
+            // Return it
+            return object;
+        }
+        
+        // If the current slab is used up, take a new slab
+        if(static_cast<std::size_t>(cache->m_end - cache->m_next) < m_size)
+            add_slab(cache);
+        
+        // Carve the object off the current slab
+        void *object = cache->m_next;
+        cache->m_next += m_size;
+        
+        // Return it
+        return object;
+    }
+    
+    inline void Slab_allocator::deallocate(void *object)
+    {
+        // Freeing 0 does nothing
+        if(!object)
+            return;
+        
+        // Obtain the cache of the calling thread
+        Cache *cache = get_cache();
+        
+        // Push the object onto the free objects
+        *static_cast<void**>(object) = cache->m_free;
+        cache->m_free = object;
+    }
+}
+
+#endif
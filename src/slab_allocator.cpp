@@ -0,0 +1,232 @@
+//
+//  slab_allocator.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <new>
+#include <algorithm>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/align/aligned_alloc.hpp>
+
+#include "slab_allocator.h"
+
+
+namespace andrews_curtis
+{
+    // Define Slab_allocator::s_slab_size, as std::max takes it by reference
+    const std::size_t Slab_allocator::s_slab_size;
+    
+    // Define Slab_allocator::s_index_header_size
+    const std::size_t Slab_allocator::s_index_header_size;
+    
+    
+    Slab_allocator::Slab_allocator(std::size_t size, bool is_indexed, std::size_t alignment)
+    :   m_size((std::max(size, sizeof(void*)) + alignment - 1) & ~(alignment - 1)),
+        m_slab_size(std::max(s_slab_size, 16*m_size)),
+        m_is_indexed(is_indexed),
+        m_index_bits(0),
+        m_max_slabs(0),
+        m_numbered_slabs(0),
+        m_cache(keep_cache),
+        m_mutex(),
+        m_slabs(),
+        m_caches(),
+        m_shared()
+    {
+        // Only indexed Slab_allocators number their slabs
+        if(!m_is_indexed)
+            return;
+        
+        // Round the slab size up to a power of 2, to align the slabs to it
+        std::size_t slab_size = s_slab_size;
+        while(slab_size < m_slab_size)
+            slab_size <<= 1;
+        m_slab_size = slab_size;
+        
+        // Obtain the number of objects in a slab, after the slab number
+        std::size_t objects = (m_slab_size - s_index_header_size) / m_size;
+        
+        // Number the objects in a slab with the fewest bits that do
+        while((0x1ul << m_index_bits) < objects)
+            ++m_index_bits;
+        
+        // Obtain the most slabs, keeping the indices below 2^32 - 1
+        m_max_slabs = (0x1ul << (32 - m_index_bits)) - 1;
+        
+        // New up the numbered slabs (Note: their pages are only touched as slabs are taken)
+        m_numbered_slabs = new char*[m_max_slabs];
+    }
+    
+    Slab_allocator::~Slab_allocator()
+    {
+        // Return the slabs
+        release();
+        
+        // Delete the caches
+        for(std::vector<Cache*>::iterator itr = m_caches.begin(); itr != m_caches.end(); ++itr)
+            delete *itr;
+        
+        // Delete the numbered slabs
+        delete[] m_numbered_slabs;
+    }
+    
+    unsigned long Slab_allocator::get_allocations()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Define the number of allocations
+        unsigned long allocations = 0;
+        
+        // Sum the allocations of the caches
+        for(std::vector<Cache*>::const_iterator itr = m_caches.begin(); itr != m_caches.end(); ++itr)
+            allocations += (*itr)->m_allocations;
+        
+        // Return the number of allocations
+        return allocations;
+    }
+    
+    unsigned long Slab_allocator::get_bytes()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Return the bytes held in slabs
+        return m_slabs.size() * m_slab_size;
+    }
+    
+    void Slab_allocator::share()
+    {
+        // Obtain the cache of the calling thread
+        Cache *cache = get_cache();
+        
+        // Obtain the number of objects in a slab, the most in a shared list
+        std::size_t objects = m_slab_size / m_size;
+        
+        // Cut the free objects into lists of a slab's objects, sharing each
+        while(cache->m_free)
+        {
+            // Take the list from the first free object
+            void *list = cache->m_free;
+            
+            // Walk to its last object, then cut the list after it
+            void *object = list;
+            for(std::size_t count = 1; (count < objects) && *static_cast<void**>(object); ++count)
+                object = *static_cast<void**>(object);
+            cache->m_free = *static_cast<void**>(object);
+            *static_cast<void**>(object) = 0;
+            
+            // Lock m_mutex
+            boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+            
+            // Share the list
+            m_shared.push_back(list);
+        }
+    }
+    
+    void Slab_allocator::release()
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // Return the slabs
+        for(std::vector<char*>::iterator itr = m_slabs.begin(); itr != m_slabs.end(); ++itr)
+        {
+            // Indexed slabs are aligned, so are returned as such
+            if(m_is_indexed)
+                boost::alignment::aligned_free(*itr);
+            else
+                ::operator delete(*itr);
+        }
+        
+        // Forget the slabs, and the shared free objects in them
+        std::vector<char*>().swap(m_slabs);
+        std::vector<void*>().swap(m_shared);
+        
+        // Empty the caches, which pointed into the slabs (Note: the counts are kept)
+        for(std::vector<Cache*>::iterator itr = m_caches.begin(); itr != m_caches.end(); ++itr)
+        {
+            (*itr)->m_free = 0;
+            (*itr)->m_next = 0;
+            (*itr)->m_end = 0;
+        }
+    }
+    
+    void Slab_allocator::add_slab(Cache *cache)
+    {
+        // If not indexed, obtain a new slab and carve objects off it
+        if(!m_is_indexed)
+        {
+            // Obtain a new slab (Note: allocates)
+            char *slab = static_cast<char*>(::operator new(m_slab_size));
+            
+            // Define scope for the lock
+            {
+                // Lock m_mutex
+                boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+                
+                // Record the slab, for release()
+                m_slabs.push_back(slab);
+            }
+            
+            // Carve objects off the new slab (Note: the rest of the old slab is dropped)
+            cache->m_next = slab;
+            cache->m_end = slab + m_slab_size;
+            
+            // Return to caller
+            return;
+        }
+        
+        // Obtain a new slab, aligned to its size
+        char *slab = static_cast<char*>(boost::alignment::aligned_alloc(m_slab_size, m_slab_size));
+        
+        // If out of memory, throw as ::operator new would
+        if(!slab)
+            throw std::bad_alloc();
+        
+        // Define scope for the lock
+        {
+            // Lock m_mutex
+            boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+            
+            // If out of indices, throw as ::operator new would
+            if(m_slabs.size() == m_max_slabs)
+            {
+                boost::alignment::aligned_free(slab);
+                throw std::bad_alloc();
+            }
+            
+            // Number the slab, holding the number at its start
+            *reinterpret_cast<unsigned int*>(slab) = static_cast<unsigned int>(m_slabs.size());
+            m_numbered_slabs[m_slabs.size()] = slab;
+            
+            // Record the slab, for release()
+            m_slabs.push_back(slab);
+        }
+        
+        // Carve objects off the new slab after its number (Note: the rest of the old slab is dropped)
+        cache->m_next = slab + s_index_header_size;
+        cache->m_end = slab + m_slab_size;
+    }
+    
+    void Slab_allocator::take_shared(Cache *cache)
+    {
+        // Lock m_mutex
+        boost::lock_guard<boost::mutex> lock_guard(m_mutex);
+        
+        // If there is a shared list, make it the free objects of cache
+        if(!m_shared.empty())
+        {
+            cache->m_free = m_shared.back();
+            m_shared.pop_back();
+        }
+    }
+    
+    void Slab_allocator::keep_cache(Cache * /* cache */)
+    {
+    }
+}
@@ -0,0 +1,211 @@
+//
+//  slab_allocator.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_slab_allocator_h
+#define Andrews_Curtis_Conjecture_slab_allocator_h
+
+
+#include <vector>
+#include <cstddef>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+
+namespace andrews_curtis
+{
+    ///
+    /// An instance of this class allocates objects of one fixed size from large
+    /// slabs. Each thread allocates from, and frees to, its own cache of free
+    /// objects and its own current slab; so, allocating and freeing takes no
+    /// lock and pays no per object header. Only taking a new slab locks.
+    ///
+    /// The slabs are only returned in bulk, by release().
+    ///
+    /// An indexed Slab_allocator also numbers its objects with 32 bit indices,
+    /// so a reference to an object may be held in 32 rather than 64 bits. Its
+    /// slabs are aligned to their size, a power of 2, and start with their
+    /// number; so, the index of an object follows from its address.
+    ///
+    class Slab_allocator
+    {
+    public:
+        ///
+        /// Constructs a Slab_allocator of objects of the passed size
+        ///
+        /// \param size The size in bytes of the allocated objects
+        /// \param is_indexed A bool indicating if the objects are indexed
+        /// \param alignment The alignment of the objects, a power of 2 of at
+        ///                  most 16, that of any fundamental type
+        ///
+        Slab_allocator(std::size_t size, bool is_indexed = false, std::size_t alignment = 16);
+        
+        ///
+        /// Destructor, returns all slabs to the system
+        ///
+        ~Slab_allocator();
+        
+        ///
+        /// Allocates an object. The object is uninitialized.
+        ///
+        /// \return The allocated object
+        ///
+        void *allocate();
+        
+        ///
+        /// Frees an object allocated by this Slab_allocator, on any thread.
+        /// The object is put in the cache of the calling thread.
+        ///
+        /// \param object The object to free, may be 0
+        ///
+        void deallocate(void *object);
+        
+        ///
+        /// Obtains the index of an object allocated by this indexed
+        /// Slab_allocator. Indices are below 2^32 - 1.
+        ///
+        /// \param object The object
+        /// \return The index of the object
+        ///
+        unsigned int get_index(const void *object) const;
+        
+        ///
+        /// Obtains the object of this indexed Slab_allocator with the passed
+        /// index, see get_index()
+        ///
+        /// \param index The index of the object
+        /// \return The object with the passed index
+        ///
+        void *get_object(unsigned int index) const;
+        
+        ///
+        /// Obtains the number of objects allocated, by all threads, since
+        /// this Slab_allocator was constructed. This is only exact if no
+        /// thread is allocating.
+        ///
+        /// \return The number of objects allocated
+        ///
+        unsigned long get_allocations();
+        
+        ///
+        /// Obtains the number of bytes held in slabs
+        ///
+        /// \return The number of bytes held in slabs
+        ///
+        unsigned long get_bytes();
+        
+        ///
+        /// Shares the free objects of the calling thread's cache with all
+        /// threads. A thread whose cache has run out takes shared objects, a
+        /// slab's worth at a time, before taking a new slab; so, objects freed
+        /// in bulk by one thread are reused by those that allocate.
+        ///
+        void share();
+        
+        ///
+        /// Returns all slabs to the system at once, invalidating every object
+        /// allocated by this Slab_allocator. No thread may be allocating.
+        ///
+        void release();
+    
+    
+    private:
+        ///
+        /// The cache of a thread. Free objects are linked through their first
+        /// bytes, and objects are carved off the end of the current slab.
+        ///
+        struct Cache
+        {
+            /// The first free object, 0 if there is none
+            void *m_free;
+            
+            /// The next unused byte of the current slab
+            char *m_next;
+            
+            /// The end of the current slab
+            char *m_end;
+            
+            /// The number of objects this thread allocated
+            unsigned long m_allocations;
+        };
+        
+        /// The size in bytes of a slab, unless 16 objects do not fit in it
+        static const std::size_t s_slab_size = 0x1 << 16;
+        
+        /// The size in bytes of the header of an indexed slab, holding its number
+        static const std::size_t s_index_header_size = 16;
+        
+        /// The size in bytes of the allocated objects, rounded up for alignment
+        std::size_t m_size;
+        
+        /// The size in bytes of a slab
+        std::size_t m_slab_size;
+        
+        /// A bool indicating if the objects are indexed
+        bool m_is_indexed;
+        
+        /// The number of low bits of an index numbering the object in its slab
+        unsigned int m_index_bits;
+        
+        /// The most slabs an indexed Slab_allocator may take
+        std::size_t m_max_slabs;
+        
+        /// The slabs of an indexed Slab_allocator by number, indexed by the high
+        /// bits of an index (Note: never moved, so read without a lock)
+        char **m_numbered_slabs;
+        
+        /// The cache of each thread (Note: the Caches are owned by m_caches)
+        boost::thread_specific_ptr<Cache> m_cache;
+        
+        /// Mutex for m_slabs, m_caches and m_shared
+        boost::mutex m_mutex;
+        
+        /// The slabs, in order of number
+        std::vector<char*> m_slabs;
+        
+        /// The caches of all threads that allocated
+        std::vector<Cache*> m_caches;
+        
+        /// The shared lists of free objects, each of at most a slab's objects
+        std::vector<void*> m_shared;
+    
+    
+    private:
+        //
+        // Obtains the cache of the calling thread, creating it if need be
+        //
+        // \return The cache of the calling thread
+        //
+        Cache *get_cache();
+        
+        //
+        // Gives the passed cache a new slab
+        //
+        // \param cache The cache to give a new slab
+        //
+        void add_slab(Cache *cache);
+        
+        //
+        // Gives the passed cache a shared list of free objects, if any
+        //
+        // \param cache The cache to give the free objects
+        //
+        void take_shared(Cache *cache);
+        
+        //
+        // Does nothing, as the Caches outlive their threads
+        //
+        // \param cache The cache of an exiting thread
+        //
+        static void keep_cache(Cache *cache);
+    };
+}
+
+#include "slab_allocator-inl.h"
+
+#endif
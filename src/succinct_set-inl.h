@@ -0,0 +1,39 @@
+//
+//  succinct_set-inl.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_succinct_set_inl_h
+#define Andrews_Curtis_Conjecture_succinct_set_inl_h
+
+
+#include "globals.h"
+
+
+namespace andrews_curtis
+{
+    template <class Function>
+    void Succinct_set::for_each(Function &function)
+    {
+        // Define the ids of a record
+        std::vector<unsigned int> record(g_relators_count);
+        
+        // Loop over the positions of s_buckets, the bucket being the zeros passed, calling function on the record of each one
+        std::size_t bucket = 0;
+        for(std::size_t position = 0, index = 0; index < s_size; ++position)
+        {
+            if((s_buckets[position >> 6] >> (position & 0x3F)) & 0x1)
+            {
+                get_record(bucket, index++, &record[0]);
+                function(&record[0]);
+            }
+            else
+                ++bucket;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,378 @@
+//
+//  succinct_set.cpp
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#include <algorithm>
+
+#include "globals.h"
+#include "succinct_set.h"
+#include "balanced_presentation.h"
+
+
+namespace andrews_curtis
+{
+    // Define Succinct_set::s_size
+    std::size_t Succinct_set::s_size = 0;
+    
+    // Define Succinct_set::s_id_bits
+    unsigned int Succinct_set::s_id_bits = 0;
+    
+    // Define Succinct_set::s_key_ids
+    unsigned int Succinct_set::s_key_ids = 0;
+    
+    // Define Succinct_set::s_low_bits
+    unsigned int Succinct_set::s_low_bits = 0;
+    
+    // Define Succinct_set::s_lows
+    std::vector<boost::uint64_t> Succinct_set::s_lows;
+    
+    // Define Succinct_set::s_buckets
+    std::vector<boost::uint64_t> Succinct_set::s_buckets;
+    
+    // Define Succinct_set::s_samples
+    std::vector<boost::uint64_t> Succinct_set::s_samples;
+    
+    // Define Succinct_set::s_rests
+    std::vector<boost::uint64_t> Succinct_set::s_rests;
+    
+    // Utility function to compare records lexicographically
+    bool is_lesser_succinct_record(const unsigned int *lhs, const unsigned int *rhs);
+    
+    // Utility function to sort the passed number of records, one after another, lexicographically and in place
+    void sort_succinct_records(unsigned int *records, std::size_t count);
+    
+    // Utility function returning the passed number of bits, fewer than 64, packed at the passed bit offset of the passed words
+    boost::uint64_t get_packed_bits(const std::vector<boost::uint64_t> &words, std::size_t offset, unsigned int count);
+    
+    // Utility function to pack the passed number of bits, fewer than 64, at the passed bit offset of the passed zeroed words
+    void set_packed_bits(std::vector<boost::uint64_t> &words, std::size_t offset, unsigned int count, boost::uint64_t bits);
+    
+    
+    bool Succinct_set::contains(const Balanced_presentation *balanced_presentation)
+    {
+        // If the set is empty, the presentation is not in it
+        if(!s_size)
+            return false;
+        
+        // Obtain the key of balanced_presentation, which is not in the set if it has an id interned since the set was frozen
+        boost::uint64_t key = 0;
+        for(unsigned int index = 0; index < g_relators_count; ++index)
+        {
+            boost::uint64_t relator_id = balanced_presentation->get_relator_id(index);
+            if(relator_id >> s_id_bits)
+                return false;
+            if(index < s_key_ids)
+                key = (key << s_id_bits) | relator_id;
+        }
+        
+        // Obtain its bucket and its low bits
+        boost::uint64_t bucket = key >> s_low_bits;
+        boost::uint64_t bits = key & ((static_cast<boost::uint64_t>(0x1) << s_low_bits) - 1);
+        
+        // Obtain the index of the first record of the bucket, and of the first record after it
+        std::size_t index = bucket ? (select_zero(bucket - 1) + 1 - bucket) : 0;
+        std::size_t end = select_zero(bucket) - bucket;
+        
+        // Binary search the records of the bucket, which are in order, for the first whose low bits are not lesser (Note: the ids of a few relators are in many records, so a bucket may be large)
+        for(std::size_t count = end - index; count; )
+        {
+            std::size_t half = count >> 1;
+            if(get_low(index + half) < bits)
+            {
+                index += half + 1;
+                count -= half + 1;
+            }
+            else
+                count = half;
+        }
+        
+        // Loop over the records of the bucket with the low bits of balanced_presentation
+        for(; (index < end) && (get_low(index) == bits); ++index)
+        {
+            // Compare the ids not in the key in turn, the first unequal pair deciding
+            int comparison = 0;
+            for(unsigned int id = s_key_ids; !comparison && (id < g_relators_count); ++id)
+            {
+                unsigned int rest = get_rest(index, id);
+                unsigned int relator_id = balanced_presentation->get_relator_id(id);
+                if(rest != relator_id)
+                    comparison = (rest < relator_id) ? -1 : 1;
+            }
+            
+            // If the record is that of balanced_presentation, it is in the set
+            if(!comparison)
+                return true;
+            
+            // If the record is greater, balanced_presentation is not in the set
+            if(comparison > 0)
+                return false;
+        }
+        
+        // Return false, the bucket holds no equal record
+        return false;
+    }
+    
+    void Succinct_set::freeze(std::vector<unsigned int> &records)
+    {
+        // Sort the new records, in place
+        if(!records.empty())
+            sort_succinct_records(&records[0], records.size() / g_relators_count);
+        
+        // Obtain the records of the set, sorted
+        std::vector<unsigned int> frozen;
+        frozen.reserve(s_size * g_relators_count);
+        get_sorted(frozen);
+        
+        // Free the set
+        clear();
+        
+        // If there are no records, there is nothing to code
+        if(frozen.empty() && records.empty())
+            return;
+        
+        // Set s_size
+        s_size = (frozen.size() + records.size()) / g_relators_count;
+        
+        // Obtain the number of bits of the greatest id, at least 1, and the number of ids that fit in a key
+        unsigned int greatest = std::max(frozen.empty() ? 0 : *std::max_element(frozen.begin(), frozen.end()), records.empty() ? 0 : *std::max_element(records.begin(), records.end()));
+        for(s_id_bits = 1; static_cast<boost::uint64_t>(greatest) >> s_id_bits; ++s_id_bits);
+        s_key_ids = static_cast<unsigned int>(std::min(g_relators_count, static_cast<long>(64 / s_id_bits)));
+        
+        // Obtain ceil(log2(s_size)), at least 1 and at most the bits of a key, the number of bits of a bucket, and the number of low bits
+        unsigned int key_bits = s_key_ids * s_id_bits;
+        unsigned int bucket_bits = 1;
+        while(((static_cast<std::size_t>(0x1) << bucket_bits) < s_size) && (bucket_bits < key_bits))
+            ++bucket_bits;
+        s_low_bits = key_bits - bucket_bits;
+        
+        // Obtain the number of bits of s_buckets, a one per record and a zero per bucket
+        std::size_t bucket_count = static_cast<std::size_t>(0x1) << bucket_bits;
+        std::size_t positions = s_size + bucket_count;
+        
+        // Allocate the packed low bits and ids, with a word of slack to read past the last, and the buckets, with a zero word to stop a scan
+        s_lows.assign(((s_size * s_low_bits) >> 6) + 2, 0);
+        s_buckets.assign((positions >> 6) + 2, 0);
+        s_samples.reserve((bucket_count / s_sample_zeros) + 1);
+        s_rests.assign(((s_size * (g_relators_count - s_key_ids) * s_id_bits) >> 6) + 2, 0);
+        
+        // Merge the records of the set with the new records, coding each
+        std::size_t index = 0;
+        std::size_t added = 0;
+        for(std::size_t record = 0; record < frozen.size(); record += g_relators_count)
+        {
+            for(; (added < records.size()) && is_lesser_succinct_record(&records[added], &frozen[record]); added += g_relators_count)
+                set_record(index++, &records[added]);
+            set_record(index++, &frozen[record]);
+        }
+        for(; added < records.size(); added += g_relators_count)
+            set_record(index++, &records[added]);
+        
+        // Free the merged records
+        std::vector<unsigned int>().swap(frozen);
+        std::vector<unsigned int>().swap(records);
+        
+        // Sample the position of every s_sample_zeros-th zero
+        std::size_t zeros = 0;
+        for(std::size_t position = 0; (position < positions) && (zeros < bucket_count); ++position)
+        {
+            if(!((s_buckets[position >> 6] >> (position & 0x3F)) & 0x1))
+            {
+                if(!(zeros % s_sample_zeros))
+                    s_samples.push_back(position);
+                ++zeros;
+            }
+        }
+    }
+    
+    unsigned long Succinct_set::size()
+    {
+        return s_size;
+    }
+    
+    unsigned long Succinct_set::get_bytes()
+    {
+        return (s_lows.capacity() + s_buckets.capacity() + s_samples.capacity() + s_rests.capacity()) * sizeof(boost::uint64_t);
+    }
+    
+    void Succinct_set::clear()
+    {
+        // Free the coded records and their index
+        std::vector<boost::uint64_t>().swap(s_lows);
+        std::vector<boost::uint64_t>().swap(s_buckets);
+        std::vector<boost::uint64_t>().swap(s_samples);
+        std::vector<boost::uint64_t>().swap(s_rests);
+        
+        // Reset the set
+        s_size = 0;
+        s_id_bits = 0;
+        s_key_ids = 0;
+        s_low_bits = 0;
+    }
+    
+    boost::uint64_t Succinct_set::get_low(std::size_t index)
+    {
+        return get_packed_bits(s_lows, index * s_low_bits, s_low_bits);
+    }
+    
+    unsigned int Succinct_set::get_rest(std::size_t index, unsigned int id)
+    {
+        return static_cast<unsigned int>(get_packed_bits(s_rests, (index * (g_relators_count - s_key_ids) + (id - s_key_ids)) * s_id_bits, s_id_bits));
+    }
+    
+    void Succinct_set::get_record(std::size_t bucket, std::size_t index, unsigned int *record)
+    {
+        // Obtain the key of the record
+        boost::uint64_t key = (static_cast<boost::uint64_t>(bucket) << s_low_bits) | get_low(index);
+        
+        // Split the key into its ids, the first in the highest bits
+        for(unsigned int id = s_key_ids; id; --id, key >>= s_id_bits)
+            record[id - 1] = static_cast<unsigned int>(key & ((static_cast<boost::uint64_t>(0x1) << s_id_bits) - 1));
+        
+        // Obtain the ids not in the key
+        for(unsigned int id = s_key_ids; id < g_relators_count; ++id)
+            record[id] = get_rest(index, id);
+    }
+    
+    void Succinct_set::set_record(std::size_t index, const unsigned int *record)
+    {
+        // Obtain the key of the record
+        boost::uint64_t key = 0;
+        for(unsigned int id = 0; id < s_key_ids; ++id)
+            key = (key << s_id_bits) | record[id];
+        
+        // Pack the low bits of the key
+        set_packed_bits(s_lows, index * s_low_bits, s_low_bits, key & ((static_cast<boost::uint64_t>(0x1) << s_low_bits) - 1));
+        
+        // Set the one of the record, after the zeros of the buckets before its own
+        std::size_t position = (key >> s_low_bits) + index;
+        s_buckets[position >> 6] |= static_cast<boost::uint64_t>(0x1) << (position & 0x3F);
+        
+        // Pack the ids not in the key
+        for(unsigned int id = s_key_ids; id < g_relators_count; ++id)
+            set_packed_bits(s_rests, (index * (g_relators_count - s_key_ids) + (id - s_key_ids)) * s_id_bits, s_id_bits, record[id]);
+    }
+    
+    std::size_t Succinct_set::select_zero(std::size_t zero)
+    {
+        // Start at the sampled zero at or before the zero sought
+        std::size_t position = s_samples[zero / s_sample_zeros];
+        std::size_t remaining = zero % s_sample_zeros;
+        
+        // Obtain the zeros of the word of position, at or after it
+        std::size_t word = position >> 6;
+        boost::uint64_t zeros = ~s_buckets[word] & (~static_cast<boost::uint64_t>(0x0) << (position & 0x3F));
+        
+        // Skip whole words while the zero sought is past them
+        for(std::size_t count = __builtin_popcountll(zeros); remaining >= count; count = __builtin_popcountll(zeros))
+        {
+            remaining -= count;
+            zeros = ~s_buckets[++word];
+        }
+        
+        // Clear the remaining lower zeros of the word, then the lowest one left is the zero sought
+        for(; remaining; --remaining)
+            zeros &= zeros - 1;
+        
+        // Return its position
+        return (word << 6) + __builtin_ctzll(zeros);
+    }
+    
+    void Succinct_set::get_sorted(std::vector<unsigned int> &records)
+    {
+        // Loop over the positions of s_buckets, the bucket being the zeros passed, appending a record per one
+        std::size_t bucket = 0;
+        for(std::size_t position = 0, index = 0; index < s_size; ++position)
+        {
+            if((s_buckets[position >> 6] >> (position & 0x3F)) & 0x1)
+            {
+                records.resize(records.size() + g_relators_count);
+                get_record(bucket, index++, &records[records.size() - g_relators_count]);
+            }
+            else
+                ++bucket;
+        }
+    }
+    
+    bool is_lesser_succinct_record(const unsigned int *lhs, const unsigned int *rhs)
+    {
+        return std::lexicographical_compare(lhs, lhs + g_relators_count, rhs, rhs + g_relators_count);
+    }
+    
+    void sort_succinct_records(unsigned int *records, std::size_t count)
+    {
+        // Note: A quicksort swapping whole records, so, unlike sorting pointers
+        //       to them, it takes no memory beyond the records themselves.
+        
+        // Partition the records while there are many, sorting the lesser part and looping on the greater
+        while(count > 16)
+        {
+            // Order the first, middle and last records, then move the middle one, their median, to the front as the pivot
+            unsigned int *first = records;
+            unsigned int *middle = records + (count >> 1) * g_relators_count;
+            unsigned int *last = records + (count - 1) * g_relators_count;
+            if(is_lesser_succinct_record(middle, first))
+                std::swap_ranges(middle, middle + g_relators_count, first);
+            if(is_lesser_succinct_record(last, first))
+                std::swap_ranges(last, last + g_relators_count, first);
+            if(is_lesser_succinct_record(last, middle))
+                std::swap_ranges(last, last + g_relators_count, middle);
+            std::swap_ranges(middle, middle + g_relators_count, first);
+            
+            // Partition the records about the pivot (Note: the last record, not lesser than the pivot, stops the first scan up, and the pivot the first scan down)
+            std::size_t left = 0;
+            std::size_t right = count;
+            while(true)
+            {
+                while(is_lesser_succinct_record(records + (++left) * g_relators_count, first));
+                while(is_lesser_succinct_record(first, records + (--right) * g_relators_count));
+                if(left >= right)
+                    break;
+                std::swap_ranges(records + left * g_relators_count, records + (left + 1) * g_relators_count, records + right * g_relators_count);
+            }
+            
+            // Move the pivot between the parts
+            std::swap_ranges(first, first + g_relators_count, records + right * g_relators_count);
+            
+            // Sort the lesser part, then loop on the greater
+            if(right < (count - right - 1))
+            {
+                sort_succinct_records(records, right);
+                records += (right + 1) * g_relators_count;
+                count -= right + 1;
+            }
+            else
+            {
+                sort_succinct_records(records + (right + 1) * g_relators_count, count - right - 1);
+                count = right;
+            }
+        }
+        
+        // Insertion sort the few records left
+        for(std::size_t record = 1; record < count; ++record)
+            for(std::size_t index = record; index && is_lesser_succinct_record(records + index * g_relators_count, records + (index - 1) * g_relators_count); --index)
+                std::swap_ranges(records + index * g_relators_count, records + (index + 1) * g_relators_count, records + (index - 1) * g_relators_count);
+    }
+    
+    boost::uint64_t get_packed_bits(const std::vector<boost::uint64_t> &words, std::size_t offset, unsigned int count)
+    {
+        // Read the bits, from the next word too if they straddle two
+        boost::uint64_t bits = words[offset >> 6] >> (offset & 0x3F);
+        if((offset & 0x3F) + count > 64)
+            bits |= words[(offset >> 6) + 1] << (64 - (offset & 0x3F));
+        
+        // Return them, masked
+        return bits & ((static_cast<boost::uint64_t>(0x1) << count) - 1);
+    }
+    
+    void set_packed_bits(std::vector<boost::uint64_t> &words, std::size_t offset, unsigned int count, boost::uint64_t bits)
+    {
+        // Write the bits, into the next word too if they straddle two
+        words[offset >> 6] |= bits << (offset & 0x3F);
+        if((offset & 0x3F) + count > 64)
+            words[(offset >> 6) + 1] |= bits >> (64 - (offset & 0x3F));
+    }
+}
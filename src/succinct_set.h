@@ -0,0 +1,182 @@
+//
+//  succinct_set.h
+//  Andrews-Curtis Conjecture
+//
+//  Created by Kelly Davis on 10/17/26.
+//
+//
+
+#ifndef Andrews_Curtis_Conjecture_succinct_set_h
+#define Andrews_Curtis_Conjecture_succinct_set_h
+
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+
+namespace andrews_curtis
+{
+    // Forward declarations
+    class Balanced_presentation;
+    
+    ///
+    /// This class encapsulates the functionality of a global, immutable set of
+    /// the presentations of completed levels. A presentation is held as the
+    /// Relator_table ids of its relators, a record, so it is held exactly, and
+    /// the records are sorted and Elias-Fano coded.
+    ///
+    /// Of n records whose ids are all below 2^b, the first k ids of each, as
+    /// many as fit in 64 bits, are concatenated b bits apiece into a key. The
+    /// low l = kb - ceil(log2 n) bits of each key are packed in an array, and
+    /// the high bits, the bucket, are coded in unary in a bit vector of at most
+    /// 3n bits. Any further ids are packed, b bits apiece, in another array. So,
+    /// a record of two relators takes at most l + 3 bits rather than 64, 19
+    /// bits for 2^20 relators and 2^24 records. Only freeze() changes the set;
+    /// contains() may be called by many threads at once.
+    ///
+    class Succinct_set
+    {
+    public:
+        ///
+        /// Returns a bool indicating if the passed presentation is in the set
+        ///
+        /// \param balanced_presentation The presentation to look up
+        /// \return A bool indicating if the presentation is in the set
+        ///
+        static bool contains(const Balanced_presentation *balanced_presentation);
+        
+        ///
+        /// Adds the passed presentations, a completed level, to the set. None
+        /// may already be in the set. No thread may be calling contains().
+        ///
+        /// \param records The ids of the relators of the presentations, one
+        ///                presentation after another
+        ///
+        static void freeze(std::vector<unsigned int> &records);
+        
+        ///
+        /// Calls the passed function on the ids of each presentation in the set
+        ///
+        /// \param function The function to call, on the ids of a presentation
+        ///
+        template <class Function> static void for_each(Function &function);
+        
+        ///
+        /// Obtains the number of presentations in the set
+        ///
+        /// \return The number of presentations in the set
+        ///
+        static unsigned long size();
+        
+        ///
+        /// Obtains the number of bytes of the set, its coded records and their
+        /// index
+        ///
+        /// \return The number of bytes of the set
+        ///
+        static unsigned long get_bytes();
+        
+        ///
+        /// Clears the set of all presentations
+        ///
+        static void clear();
+    
+    
+    private:
+        /// The number of zeros of s_buckets between samples of their positions
+        static const std::size_t s_sample_zeros = 256;
+        
+        /// Note: Bucket k of the records, those whose key has the high bits k,
+        /// is coded as a one for each of its records and then a zero. So, bucket
+        /// k starts just after zero k - 1, and its first record is the one at
+        /// that position less k. The position of every 256th zero is sampled, so
+        /// zero k - 1 is found by a scan of a few words.
+        
+        /// Note: The key holds as many ids as fit in 64 bits, at least two, so
+        /// records with equal keys, which are adjacent, are told apart by the
+        /// ids packed in s_rests. The width b is that of the greatest id frozen,
+        /// so an id interned since is not in the set.
+        
+        /// The number of presentations in the set
+        static std::size_t s_size;
+        
+        /// The number of bits of an id, b
+        static unsigned int s_id_bits;
+        
+        /// The number of ids of a record in its key
+        static unsigned int s_key_ids;
+        
+        /// The number of low bits of a key packed in s_lows, l
+        static unsigned int s_low_bits;
+        
+        /// The low bits of the keys, packed, in order
+        static std::vector<boost::uint64_t> s_lows;
+        
+        /// The buckets of the keys, coded in unary
+        static std::vector<boost::uint64_t> s_buckets;
+        
+        /// The position in s_buckets of every s_sample_zeros-th zero
+        static std::vector<boost::uint64_t> s_samples;
+        
+        /// The ids of the records not in their keys, packed, in order
+        static std::vector<boost::uint64_t> s_rests;
+    
+    
+    private:
+        //
+        // Returns the low bits of the key of the record with the passed index
+        //
+        // \param index The index of the record
+        // \return The low bits of the key
+        //
+        static boost::uint64_t get_low(std::size_t index);
+        
+        //
+        // Returns the id, not in the key, of the record with the passed index
+        //
+        // \param index The index of the record
+        // \param id The index of the id, at least s_key_ids
+        // \return The id
+        //
+        static unsigned int get_rest(std::size_t index, unsigned int id);
+        
+        //
+        // Obtains the ids of the record with the passed bucket and index
+        //
+        // \param bucket The bucket of the record
+        // \param index The index of the record
+        // \param record Set to the ids of the record
+        //
+        static void get_record(std::size_t bucket, std::size_t index, unsigned int *record);
+        
+        //
+        // Codes the passed record, with the passed index, into the set
+        //
+        // \param index The index of the record
+        // \param record The ids of the record
+        //
+        static void set_record(std::size_t index, const unsigned int *record);
+        
+        //
+        // Returns the position in s_buckets of the zero with the passed index
+        //
+        // \param zero The index of the zero
+        // \return The position of the zero
+        //
+        static std::size_t select_zero(std::size_t zero);
+        
+        //
+        // Appends the ids of the records of the set, in order, to the passed
+        // array
+        //
+        // \param records The array to append the ids of the records to
+        //
+        static void get_sorted(std::vector<unsigned int> &records);
+    };
+}
+
+#include "succinct_set-inl.h"
+
+#endif